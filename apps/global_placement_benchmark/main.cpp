@@ -0,0 +1,73 @@
+#include <iostream>
+#include <chrono>
+
+#include "../global_placement/analytic_placer.h"
+#include "../legalization/algorithms/abacus.h"
+#include "../legalization/legalization_check.h"
+#include "../parsing/def.h"
+#include "../parsing/lef.h"
+#include "../parsing/verilog.h"
+#include "../netlist/verilog2netlist.h"
+#include "../placement/def2placement.h"
+#include "../placement/lef2library.h"
+#include "../floorplan/lefdef2floorplan.h"
+
+using namespace ophidian;
+
+// Places a design from scratch with the analytic global placer, printing the
+// wirelength, density overflow and runtime of every iteration, then legalizes
+// the result with Abacus.
+
+using clock_type = std::chrono::steady_clock;
+
+double elapsed_ms(clock_type::time_point begin) {
+    return std::chrono::duration<double, std::milli>(clock_type::now()-begin).count();
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc != 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " <.v> <.def> <.lef>" << std::endl;
+        std::cerr << "Example " << argv[0] << " simple.v simple.def simple.lef" << std::endl;
+        return -1;
+    }
+
+    standard_cell::standard_cells std_cells;
+    netlist::netlist netlist{&std_cells};
+    placement::library placement_lib{&std_cells};
+    placement::placement placement{&netlist, &placement_lib};
+    floorplan::floorplan floorplan;
+    {
+        parsing::verilog v(argv[1]);
+        netlist::verilog2netlist(v, netlist);
+        parsing::lef lef(argv[3]);
+        placement::lef2library(lef, placement_lib);
+        parsing::def def(argv[2]);
+        placement::def2placement(def, placement);
+        floorplan::lefdef2floorplan(lef, def, floorplan);
+    }
+
+    auto begin = clock_type::now();
+    global_placement::analytic_placer placer(&floorplan, &placement);
+    std::cout << "movable cells: " << placer.movable_cell_count() << std::endl;
+    std::cout << "initial hpwl: " << placer.hpwl() << std::endl;
+    placer.place();
+    const double global_ms = elapsed_ms(begin);
+
+    std::cout << "iteration\thpwl\toverflow\tms" << std::endl;
+    for(auto & iteration : placer.report())
+        std::cout << iteration.iteration << "\t" << iteration.hpwl << "\t" << iteration.overflow << "\t" << iteration.milliseconds << std::endl;
+    std::cout << "global placement: " << global_ms << " ms, hpwl " << placer.hpwl() << std::endl;
+
+    begin = clock_type::now();
+    legalization::abacus::abacus abacus(&floorplan, &placement);
+    abacus.legalize_placement();
+    const double legalization_ms = elapsed_ms(begin);
+    global_placement::analytic_placer legalized(&floorplan, &placement);
+    legalization::legalization_check check(&floorplan, &placement);
+    const bool legal = check.check_legality();
+    std::cout << "legalization: " << legalization_ms << " ms, hpwl " << legalized.hpwl() << ", " << (legal ? "legal" : "illegal") << std::endl;
+
+    return legal ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <chrono>
+#include <omp.h>
+
+#include "../timing-driven_placement/flute_rc_tree_estimation.h"
+#include "../parsing/def.h"
+#include "../parsing/lef.h"
+#include "../parsing/verilog.h"
+#include "../netlist/verilog2netlist.h"
+#include "../placement/def2placement.h"
+#include "../placement/lef2library.h"
+#include "../timing/liberty.h"
+#include "../timing/design_constraints.h"
+
+using namespace ophidian;
+
+// Estimates the rc trees of every net with FLUTE, as the timing-driven
+// placement does on its first timing update, once for each thread count, and
+// prints the scaling curve. The trees of every run must match the serial run.
+
+using clock_type = std::chrono::steady_clock;
+
+double elapsed_ms(clock_type::time_point begin) {
+    return std::chrono::duration<double, std::milli>(clock_type::now()-begin).count();
+}
+
+void estimate_all(const placement::placement & placement, const timing::library & lib, timingdriven_placement::flute_rc_tree_creator & flute, const std::vector<entity_system::entity> & nets, const std::vector<entity_system::entity> & sources, std::vector< interconnection::packed_rc_tree > & trees) {
+    std::size_t i;
+#pragma omp parallel for schedule(dynamic, 64)
+    for(i = 0; i < nets.size(); ++i)
+    {
+        interconnection::rc_tree tree;
+        auto map = flute.create_tree(placement, nets[i], tree, lib);
+        trees[i] = tree.pack(map.at(sources[i]));
+    }
+}
+
+bool same_trees(const interconnection::packed_rc_tree & a, const interconnection::packed_rc_tree & b) {
+    if(a.node_count() != b.node_count())
+        return false;
+    for(std::size_t i = 0; i < a.node_count(); ++i)
+    {
+        if(a.preds()[i] != b.preds()[i] || a.resistances()[i] != b.resistances()[i] || a.capacitances()[i] != b.capacitances()[i])
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc < 5 || argc > 6)
+    {
+        std::cerr << "Usage: " << argv[0] << " <.v> <.def> <.lef> <.lib> [repetitions]" << std::endl;
+        std::cerr << "Example " << argv[0] << " simple.v simple.def simple.lef simple_Late.lib 10" << std::endl;
+        return -1;
+    }
+    const int repetitions = argc == 6 ? std::stoi(argv[5]) : 10;
+
+    standard_cell::standard_cells std_cells;
+    netlist::netlist netlist{&std_cells};
+    placement::library placement_lib{&std_cells};
+    placement::placement placement{&netlist, &placement_lib};
+    timing::library_timing_arcs tarcs{&std_cells};
+    timing::library lib{&tarcs, &std_cells};
+    {
+        parsing::verilog v(argv[1]);
+        netlist::verilog2netlist(v, netlist);
+        parsing::lef lef(argv[3]);
+        placement::lef2library(lef, placement_lib);
+        parsing::def def(argv[2]);
+        placement::def2placement(def, placement);
+    }
+    auto dc = timing::default_design_constraints{netlist}.dc();
+    for(auto driver : dc.input_drivers)
+        std_cells.pin_direction(netlist.pin_std_cell(netlist.pin_by_name(driver.port_name)), standard_cell::pin_directions::OUTPUT);
+    std_cells.pin_direction(netlist.pin_std_cell(netlist.pin_by_name(dc.clock.port_name)), standard_cell::pin_directions::OUTPUT);
+    timing::liberty::read(argv[4], lib);
+
+    std::vector<entity_system::entity> nets;
+    std::vector<entity_system::entity> sources;
+    for(auto net : netlist.net_system())
+    {
+        for(auto pin : netlist.net_pins(net))
+        {
+            if(std_cells.pin_direction(netlist.pin_std_cell(pin)) == standard_cell::pin_directions::OUTPUT)
+            {
+                nets.push_back(net);
+                sources.push_back(pin);
+                break;
+            }
+        }
+    }
+    std::cout << "nets: " << nets.size() << std::endl;
+
+    timingdriven_placement::flute_rc_tree_creator flute;
+    std::vector< interconnection::packed_rc_tree > serial(nets.size());
+    std::vector< interconnection::packed_rc_tree > trees(nets.size());
+
+    std::size_t mismatches = 0;
+    double serial_ms = 0.0;
+    std::cout << "threads\tms\tspeedup\tefficiency" << std::endl;
+    for(int threads = 1; threads <= omp_get_max_threads(); threads *= 2)
+    {
+        omp_set_num_threads(threads);
+        estimate_all(placement, lib, flute, nets, sources, trees); // warm up the per-thread buffers
+        auto begin = clock_type::now();
+        for(int i = 0; i < repetitions; ++i)
+            estimate_all(placement, lib, flute, nets, sources, trees);
+        const double ms = elapsed_ms(begin)/repetitions;
+        if(threads == 1)
+        {
+            serial_ms = ms;
+            serial = trees;
+        }
+        for(std::size_t i = 0; i < nets.size(); ++i)
+            if(!same_trees(serial[i], trees[i]))
+                ++mismatches;
+        std::cout << threads << "\t" << ms << "\t" << serial_ms/ms << "\t" << serial_ms/ms/threads << std::endl;
+    }
+    std::cout << "mismatching trees: " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+#include <iostream>
+#include <chrono>
+
+#include "../timing/generic_sta.h"
+#include "../timing/graph_builder.h"
+#include "../timing/liberty.h"
+#include "../parsing/verilog.h"
+#include "../netlist/verilog2netlist.h"
+
+#include <boost/units/systems/si/prefixes.hpp>
+
+using namespace ophidian;
+using namespace boost::units;
+
+// Compares one forward (arrival) and one backward (required) sweep over the
+// timing graph stored as lemon lists and as the csr snapshot used by the STA.
+// The arithmetic is the same in both sweeps, only the graph layout changes.
+
+using clock_type = std::chrono::steady_clock;
+
+double elapsed_ms(clock_type::time_point begin) {
+    return std::chrono::duration<double, std::milli>(clock_type::now()-begin).count();
+}
+
+void lemon_sweep(const timing::graph & g, const std::vector<lemon::ListDigraph::Node> & sorted, const lemon::ListDigraph::ArcMap<double> & delays, lemon::ListDigraph::NodeMap<double> & arrivals, lemon::ListDigraph::NodeMap<double> & requireds) {
+    const lemon::ListDigraph & G = g.G();
+    for(auto node : sorted)
+    {
+        if(lemon::countInArcs(G, node) == 0)
+            continue;
+        double arrival = std::numeric_limits<double>::lowest();
+        for(lemon::ListDigraph::InArcIt arc(G, node); arc != lemon::INVALID; ++arc)
+            arrival = std::max(arrival, arrivals[G.source(arc)] + delays[arc]);
+        arrivals[node] = arrival;
+    }
+    for(auto node_it = sorted.rbegin(); node_it != sorted.rend(); ++node_it)
+    {
+        if(lemon::countOutArcs(G, *node_it) == 0)
+            continue;
+        double required = std::numeric_limits<double>::max();
+        for(lemon::ListDigraph::OutArcIt arc(G, *node_it); arc != lemon::INVALID; ++arc)
+            required = std::min(required, requireds[G.target(arc)] - delays[arc]);
+        requireds[*node_it] = required;
+    }
+}
+
+void csr_sweep(const timing::csr_graph & G, const std::vector<double> & delays, std::vector<double> & arrivals, std::vector<double> & requireds) {
+    for(timing::csr_graph::index node = 0; node < G.node_count(); ++node)
+    {
+        if(G.in_degree(node) == 0)
+            continue;
+        double arrival = std::numeric_limits<double>::lowest();
+        for(auto arc = G.in_arcs_begin(node); arc != G.in_arcs_end(node); ++arc)
+            arrival = std::max(arrival, arrivals[G.source(*arc)] + delays[*arc]);
+        arrivals[node] = arrival;
+    }
+    for(std::size_t i = G.node_count(); i > 0; --i)
+    {
+        const timing::csr_graph::index node = static_cast<timing::csr_graph::index>(i-1);
+        if(G.out_degree(node) == 0)
+            continue;
+        double required = std::numeric_limits<double>::max();
+        for(auto arc = G.out_arcs_begin(node); arc != G.out_arcs_end(node); ++arc)
+            required = std::min(required, requireds[G.target(arc)] - delays[arc]);
+        requireds[node] = required;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc < 3 || argc > 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " <.v> <.lib> [repetitions]" << std::endl;
+        std::cerr << "Example " << argv[0] << " simple.v simple_Late.lib 100" << std::endl;
+        return -1;
+    }
+    const int repetitions = argc == 4 ? std::stoi(argv[3]) : 100;
+
+    standard_cell::standard_cells std_cells;
+    netlist::netlist netlist{&std_cells};
+    timing::library_timing_arcs tarcs{&std_cells};
+    timing::library lib{&tarcs, &std_cells};
+    {
+        parsing::verilog v(argv[1]);
+        netlist::verilog2netlist(v, netlist);
+    }
+    auto dc = timing::default_design_constraints{netlist}.dc();
+    for(auto driver : dc.input_drivers)
+        std_cells.pin_direction(netlist.pin_std_cell(netlist.pin_by_name(driver.port_name)), standard_cell::pin_directions::OUTPUT);
+    std_cells.pin_direction(netlist.pin_std_cell(netlist.pin_by_name(dc.clock.port_name)), standard_cell::pin_directions::OUTPUT);
+    timing::liberty::read(argv[2], lib);
+    for(auto out_load : dc.output_loads)
+        std_cells.pin_direction(netlist.pin_std_cell(netlist.pin_by_name(out_load.port_name)), standard_cell::pin_directions::INPUT);
+
+    timing::graph graph;
+    timing::graph_builder::build(netlist, lib, dc, graph);
+
+    auto begin = clock_type::now();
+    timing::graph_and_topology topology(graph, netlist, lib);
+    std::cout << "topology and csr snapshot: " << elapsed_ms(begin) << " ms" << std::endl;
+    const timing::csr_graph & csr = topology.csr;
+    std::cout << "nodes: " << csr.node_count() << " arcs: " << csr.arc_count() << " levels: " << topology.levels.size() << std::endl;
+
+    lemon::ListDigraph::ArcMap<double> lemon_delays(graph.G());
+    lemon::ListDigraph::NodeMap<double> lemon_arrivals(graph.G(), 0.0);
+    lemon::ListDigraph::NodeMap<double> lemon_requireds(graph.G(), 0.0);
+    std::vector<double> csr_delays(csr.arc_count());
+    std::vector<double> csr_arrivals(csr.node_count(), 0.0);
+    std::vector<double> csr_requireds(csr.node_count(), 0.0);
+    for(std::size_t a = 0; a < csr.arc_count(); ++a)
+    {
+        csr_delays[a] = 1.0 + static_cast<double>(a % 7);
+        lemon_delays[csr.arc(a)] = csr_delays[a];
+    }
+
+    begin = clock_type::now();
+    for(int i = 0; i < repetitions; ++i)
+        lemon_sweep(graph, topology.sorted, lemon_delays, lemon_arrivals, lemon_requireds);
+    const double lemon_ms = elapsed_ms(begin);
+
+    begin = clock_type::now();
+    for(int i = 0; i < repetitions; ++i)
+        csr_sweep(csr, csr_delays, csr_arrivals, csr_requireds);
+    const double csr_ms = elapsed_ms(begin);
+
+    std::size_t mismatches = 0;
+    for(auto node : topology.sorted)
+    {
+        auto i = csr.node_index(node);
+        if(lemon_arrivals[node] != csr_arrivals[i] || lemon_requireds[node] != csr_requireds[i])
+            ++mismatches;
+    }
+
+    std::cout << "lemon lists: " << lemon_ms/repetitions << " ms per sweep" << std::endl;
+    std::cout << "csr snapshot: " << csr_ms/repetitions << " ms per sweep" << std::endl;
+    std::cout << "speedup: " << lemon_ms/csr_ms << "x" << std::endl;
+    std::cout << "mismatching nodes: " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
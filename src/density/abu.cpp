@@ -21,18 +21,36 @@ under the License.
 #include "abu.h"
 #include "../../apps/placement_viewer/application.h"
 
+#include <algorithm>
+#include <functional>
+
 namespace ophidian {
     namespace density {
 
         double abu::measure_abu(double target_utilization, std::vector<double> abu_ranges, std::vector<double> abu_weights, double bin_area_threshold, double free_space_threshold) {
             assert(abu_ranges.size() == abu_weights.size());
 
-            std::vector<double> utilizations;
-            m_density.build_density_map(m_bin_dimensions, utilizations);
+            if (!m_density.has_grid()) {
+                m_density.build_grid(m_bin_dimensions);
+            }
+            m_density.utilizations(m_utilizations, bin_area_threshold, free_space_threshold);
+            if (m_utilizations.empty()) {
+                return 0.0;
+            }
+
+            // only the densest bins of the widest range are needed, in decreasing order
+            std::size_t number_of_bins = m_density.bin_count() - m_density.skipped_bins();
+            std::size_t densest = 1;
+            for (auto range : abu_ranges) {
+                densest = std::max(densest, static_cast<std::size_t>(range * number_of_bins));
+            }
+            densest = std::min(densest, m_utilizations.size());
+            std::nth_element(m_utilizations.begin(), m_utilizations.begin() + densest - 1, m_utilizations.end(), std::greater<double>());
+            std::sort(m_utilizations.begin(), m_utilizations.begin() + densest, std::greater<double>());
 
             double numerator = 0.0, denominator = 0.0;
             for (size_t abu_range_id = 0; abu_range_id < abu_ranges.size(); abu_range_id++) {
-                double abu = measure_abu_for_range(abu_ranges.at(abu_range_id), utilizations, target_utilization);
+                double abu = measure_abu_for_range(abu_ranges.at(abu_range_id), m_utilizations, number_of_bins, target_utilization);
                 numerator += abu * abu_weights.at(abu_range_id);
                 denominator += abu_weights.at(abu_range_id);
             }
@@ -40,15 +58,13 @@ namespace ophidian {
             return abu;
         }
 
-        double abu::measure_abu_for_range(double range, std::vector<double> &utilizations, double target_utilization) {
-            size_t number_of_bins = m_density.bin_count();
-
+        double abu::measure_abu_for_range(double range, const std::vector<double> &densest_utilizations, std::size_t number_of_bins, double target_utilization) {
             double local_abu = 0;
-            int clip_index = range * (number_of_bins - m_density.skipped_bins());
-            for (size_t bin_index = number_of_bins-1; bin_index > number_of_bins-1-clip_index; bin_index--) {
-                local_abu += utilizations.at(bin_index);
+            int clip_index = range * number_of_bins;
+            for (int bin_index = 0; bin_index < clip_index; bin_index++) {
+                local_abu += densest_utilizations.at(bin_index);
             }
-            local_abu = (clip_index) ? local_abu / clip_index : utilizations.at(number_of_bins - 1);
+            local_abu = (clip_index) ? local_abu / clip_index : densest_utilizations.at(0);
             local_abu = std::max(0.0, local_abu / target_utilization - 1.0);
             return local_abu;
         }
@@ -42,7 +42,9 @@ namespace ophidian {
 
             point m_bin_dimensions;
 
-            double measure_abu_for_range(double range, std::vector<double> & utilizations, double target_utilization);
+            std::vector<double> m_utilizations;
+
+            double measure_abu_for_range(double range, const std::vector<double> & densest_utilizations, std::size_t number_of_bins, double target_utilization);
         public:
 
             abu(floorplan::floorplan * floorplan, placement::placement * placement, point bin_dimensions)
@@ -52,6 +54,12 @@ namespace ophidian {
 
             ~abu() { }
 
+            /// Updates the density map after a cell has been moved from old_position to new_position.
+            void cell_moved(entity_system::entity cell, point old_position, point new_position) {
+                m_density.cell_moved(cell, old_position, new_position);
+            }
+
+            /// Measures ABU; the density map is built on the first call and kept up to date by cell_moved() afterwards.
             double measure_abu(double target_utilization, std::vector<double> abu_ranges = {0.02, 0.05, 0.1, 0.2}, std::vector<double> abu_weights = {10, 4, 2, 1}, double bin_area_threshold = 0.2, double free_space_threshold = 0.2);
         };
     }
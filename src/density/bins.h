@@ -71,24 +71,24 @@ namespace ophidian {
                 return m_free_space[m_system.lookup(bin)];
             }
 
-            std::pair< std::vector<point>::const_iterator, std::vector<point>::const_iterator > positions() const {
-                return std::make_pair(m_positions.begin(), m_positions.end());
+            const entity_system::vector_property<point> & positions() const {
+                return m_positions;
             }
 
-            std::pair< std::vector<point>::const_iterator, std::vector<point>::const_iterator > dimensions() const {
-                return std::make_pair(m_dimensions.begin(), m_dimensions.end());
+            const entity_system::vector_property<point> & dimensions() const {
+                return m_dimensions;
             }
 
-            std::pair< std::vector<double>::const_iterator, std::vector<double>::const_iterator > movable_utilizations() const {
-                return std::make_pair(m_movable_utilization.begin(), m_movable_utilization.end());
+            const entity_system::vector_property<double> & movable_utilizations() const {
+                return m_movable_utilization;
             }
 
-            std::pair< std::vector<double>::const_iterator, std::vector<double>::const_iterator > fixed_utilizations() const {
-                return std::make_pair(m_fixed_utilization.begin(), m_fixed_utilization.end());
+            const entity_system::vector_property<double> & fixed_utilizations() const {
+                return m_fixed_utilization;
             }
 
-            std::pair< std::vector<double>::const_iterator, std::vector<double>::const_iterator > free_spaces() const {
-                return std::make_pair(m_free_space.begin(), m_free_space.end());
+            const entity_system::vector_property<double> & free_spaces() const {
+                return m_free_space;
             }
 
             void position(entity_system::entity bin, point position);
@@ -20,6 +20,10 @@ under the License.
 
 #include "density_map.h"
 
+#include <algorithm>
+#include <cassert>
+#include <omp.h>
+
 namespace ophidian {
     namespace density {
 
@@ -39,6 +43,17 @@ namespace ophidian {
         }
 
         void density_map::intersecting_bins(box region, std::vector<entity_system::entity> &bins) {
+            if (has_grid()) {
+                std::size_t first_column, last_column, first_row, last_row;
+                grid_range(region, first_column, last_column, first_row, last_row);
+                bins.reserve(bins.size() + (last_column - first_column + 1) * (last_row - first_row + 1));
+                for (std::size_t row = first_row; row <= last_row; row++) {
+                    for (std::size_t column = first_column; column <= last_column; column++) {
+                        bins.push_back(m_grid[row * m_grid_columns + column]);
+                    }
+                }
+                return;
+            }
             std::vector<rtree_node> intersecting_nodes;
             m_bins_rtree.query(boost::geometry::index::intersects(region), std::back_inserter(intersecting_nodes));
             bins.reserve(intersecting_nodes.size());
@@ -59,69 +74,182 @@ namespace ophidian {
             m_bins.free_space(bin, free_space);
         }
 
-        void density_map::build_density_map(point max_bin_dimensions, std::vector<double> &utilizations, double bin_area_threshold, double free_space_threshold) {
-            std::pair<unsigned, unsigned> number_of_bins(std::ceil(m_floorplan->chip_boundaries().x() / max_bin_dimensions.x()),
-                                                         std::ceil(m_floorplan->chip_boundaries().y() / max_bin_dimensions.y()));
-            for (unsigned y_index = 0; y_index < number_of_bins.second; y_index++) {
-                for (unsigned x_index = 0; x_index < number_of_bins.first; x_index++) {
-                    point bin_position(m_floorplan->chip_origin().x() + (x_index * max_bin_dimensions.x()),
-                                       m_floorplan->chip_origin().y() + (y_index * max_bin_dimensions.y()));
+        void density_map::grid_range(const box &region, std::size_t &first_column, std::size_t &last_column, std::size_t &first_row, std::size_t &last_row) const {
+            auto index = [](double offset, double bin_size, std::size_t count) -> std::size_t {
+                double index = std::floor(offset / bin_size);
+                if (index < 0) {
+                    return 0;
+                }
+                return std::min(static_cast<std::size_t>(index), count - 1);
+            };
+            first_column = index(region.min_corner().x() - m_grid_origin.x(), m_grid_bin_dimensions.x(), m_grid_columns);
+            last_column = index(region.max_corner().x() - m_grid_origin.x(), m_grid_bin_dimensions.x(), m_grid_columns);
+            first_row = index(region.min_corner().y() - m_grid_origin.y(), m_grid_bin_dimensions.y(), m_grid_rows);
+            last_row = index(region.max_corner().y() - m_grid_origin.y(), m_grid_bin_dimensions.y(), m_grid_rows);
+        }
+
+        void density_map::grid_add_area(const box &region, double sign, bool fixed) {
+            std::size_t first_column, last_column, first_row, last_row;
+            grid_range(region, first_column, last_column, first_row, last_row);
+            for (std::size_t row = first_row; row <= last_row; row++) {
+                for (std::size_t column = first_column; column <= last_column; column++) {
+                    auto bin = m_grid[row * m_grid_columns + column];
+                    point position = m_bins.position(bin);
+                    point dimension = m_bins.dimension(bin);
+                    double width = std::min(region.max_corner().x(), position.x() + dimension.x()) - std::max(region.min_corner().x(), position.x());
+                    double height = std::min(region.max_corner().y(), position.y() + dimension.y()) - std::max(region.min_corner().y(), position.y());
+                    if (width <= 0 || height <= 0) {
+                        continue;
+                    }
+                    if (fixed) {
+                        bin_fixed_utilization(bin, bin_fixed_utilization(bin) + sign * width * height);
+                    } else {
+                        bin_movable_utilization(bin, bin_movable_utilization(bin) + sign * width * height);
+                    }
+                }
+            }
+        }
+
+        void density_map::grid_add_area(const box &region, std::vector<double> &areas) {
+            std::size_t first_column, last_column, first_row, last_row;
+            grid_range(region, first_column, last_column, first_row, last_row);
+            for (std::size_t row = first_row; row <= last_row; row++) {
+                for (std::size_t column = first_column; column <= last_column; column++) {
+                    const std::size_t index = row * m_grid_columns + column;
+                    auto bin = m_grid[index];
+                    point position = m_bins.position(bin);
+                    point dimension = m_bins.dimension(bin);
+                    double width = std::min(region.max_corner().x(), position.x() + dimension.x()) - std::max(region.min_corner().x(), position.x());
+                    double height = std::min(region.max_corner().y(), position.y() + dimension.y()) - std::max(region.min_corner().y(), position.y());
+                    if (width > 0 && height > 0) {
+                        areas[index] += width * height;
+                    }
+                }
+            }
+        }
+
+        void density_map::build_grid(point max_bin_dimensions) {
+            m_grid_origin = m_floorplan->chip_origin();
+            m_grid_bin_dimensions = max_bin_dimensions;
+            m_grid_columns = std::ceil(m_floorplan->chip_boundaries().x() / max_bin_dimensions.x());
+            m_grid_rows = std::ceil(m_floorplan->chip_boundaries().y() / max_bin_dimensions.y());
+            m_grid.clear();
+            m_grid.reserve(m_grid_columns * m_grid_rows);
+            for (std::size_t y_index = 0; y_index < m_grid_rows; y_index++) {
+                for (std::size_t x_index = 0; x_index < m_grid_columns; x_index++) {
+                    point bin_position(m_grid_origin.x() + (x_index * max_bin_dimensions.x()),
+                                       m_grid_origin.y() + (y_index * max_bin_dimensions.y()));
                     point bin_top(std::min(bin_position.x() + max_bin_dimensions.x(), m_floorplan->chip_boundaries().x()),
                                   std::min(bin_position.y() + max_bin_dimensions.y(), m_floorplan->chip_boundaries().y()));
-                    point bin_dimensions(bin_top.x() - bin_position.x(), bin_top.y() - bin_position.y());
-                    auto bin = bin_insert(bin_position, bin_dimensions, 0, 0);
-                    box bin_region(bin_position, {bin_position.x() + bin_dimensions.x(), bin_position.y() + bin_dimensions.y()});
-                    std::vector<entity_system::entity> intersecting_rows;
-                    std::vector<rtree_node> intersecting_nodes;
-                    m_rows_rtree.query(boost::geometry::index::intersects(bin_region), std::back_inserter(intersecting_nodes));
-                    for (auto node : intersecting_nodes) {
-                        box row_box = node.first;
-                        box intersection;
-                        boost::geometry::intersection(bin_region, row_box, intersection);
-                        double intersection_area = (intersection.max_corner().x() - intersection.min_corner().x()) * (intersection.max_corner().y() - intersection.min_corner().y());
-                        bin_free_space(bin, bin_free_space(bin) + intersection_area);
+                    auto bin = m_bins_system.create();
+                    m_bins.position(bin, bin_position);
+                    m_bins.dimension(bin, point(bin_top.x() - bin_position.x(), bin_top.y() - bin_position.y()));
+                    m_bins.movable_utilization(bin, 0.0);
+                    m_bins.fixed_utilization(bin, 0.0);
+                    m_bins.free_space(bin, 0.0);
+                    m_grid.push_back(bin);
+                }
+            }
+
+            for (auto row : m_floorplan->rows_system()) {
+                point row_origin = m_floorplan->row_origin(row);
+                point row_dimensions = m_floorplan->row_dimensions(row);
+                box row_box(row_origin, {row_origin.x() + row_dimensions.x(), row_origin.y() + row_dimensions.y()});
+                std::vector<entity_system::entity> row_bins;
+                intersecting_bins(row_box, row_bins);
+                for (auto bin : row_bins) {
+                    point position = m_bins.position(bin);
+                    point dimension = m_bins.dimension(bin);
+                    double width = std::min(row_box.max_corner().x(), position.x() + dimension.x()) - std::max(row_box.min_corner().x(), position.x());
+                    double height = std::min(row_box.max_corner().y(), position.y() + dimension.y()) - std::max(row_box.min_corner().y(), position.y());
+                    if (width > 0 && height > 0) {
+                        bin_free_space(bin, bin_free_space(bin) + width * height);
                     }
                 }
             }
 
             for (auto cell : m_placement->netlist().cell_system()) {
-                auto cell_geometry = m_placement->cell_geometry(cell);
-                for (auto cell_polygon : cell_geometry) {
-                    box cell_rectangle;
-                    boost::geometry::envelope(cell_polygon, cell_rectangle);
-                    std::vector<entity_system::entity> cell_bins;
-                    intersecting_bins(cell_rectangle, cell_bins);
-
-                    for (auto & bin : cell_bins) {
-                        point current_bin_position = bin_position(bin);
-                        point current_bin_dimension = bin_dimension(bin);
-                        box bin_boundaries(current_bin_position, point(current_bin_position.x() + current_bin_dimension.x(), current_bin_position.y() + current_bin_dimension.y()));
-                        box intersection;
-                        boost::geometry::intersection(bin_boundaries, cell_rectangle, intersection);
-                        double intersection_area = (intersection.max_corner().x() - intersection.min_corner().x()) * (intersection.max_corner().y() - intersection.min_corner().y());
-                        if (m_placement->cell_fixed(cell)) {
-                            bin_fixed_utilization(bin, bin_fixed_utilization(bin) + intersection_area);
-                        } else {
-                            bin_movable_utilization(bin, bin_movable_utilization(bin) + intersection_area);
-                        }
+                bool fixed = m_placement->cell_fixed(cell);
+                point position = m_placement->cell_position(cell);
+                for (auto & rectangle : m_placement->cell_rectangles(cell)) {
+                    grid_add_area(box(point(position.x() + rectangle.min_corner().x(), position.y() + rectangle.min_corner().y()),
+                                      point(position.x() + rectangle.max_corner().x(), position.y() + rectangle.max_corner().y())), 1.0, fixed);
+                }
+            }
+        }
+
+        entity_system::entity density_map::bin_at(point position) const {
+            std::size_t first_column, last_column, first_row, last_row;
+            grid_range(box(position, position), first_column, last_column, first_row, last_row);
+            return m_grid[first_row * m_grid_columns + first_column];
+        }
+
+        void density_map::cell_moved(entity_system::entity cell, point old_position, point new_position) {
+            // rectangles are relative to the cell, so this works before or after the placement is updated
+            bool fixed = m_placement->cell_fixed(cell);
+            for (auto & rectangle : m_placement->cell_rectangles(cell)) {
+                grid_add_area(box(point(old_position.x() + rectangle.min_corner().x(), old_position.y() + rectangle.min_corner().y()),
+                                  point(old_position.x() + rectangle.max_corner().x(), old_position.y() + rectangle.max_corner().y())), -1.0, fixed);
+                grid_add_area(box(point(new_position.x() + rectangle.min_corner().x(), new_position.y() + rectangle.min_corner().y()),
+                                  point(new_position.x() + rectangle.max_corner().x(), new_position.y() + rectangle.max_corner().y())), 1.0, fixed);
+            }
+        }
+
+        void density_map::update_movable_utilizations() {
+            assert(has_grid());
+            std::vector<entity_system::entity> cells;
+            cells.reserve(m_placement->netlist().cell_count());
+            for (auto cell : m_placement->netlist().cell_system()) {
+                if (!m_placement->cell_fixed(cell)) {
+                    cells.push_back(cell);
+                }
+            }
+
+            std::vector<std::vector<double>> thread_areas(omp_get_max_threads());
+#pragma omp parallel
+            {
+                std::vector<double> & areas = thread_areas[omp_get_thread_num()];
+                areas.assign(m_grid.size(), 0.0);
+#pragma omp for schedule(static)
+                for (std::size_t i = 0; i < cells.size(); i++) {
+                    point position = m_placement->cell_position(cells[i]);
+                    for (auto & rectangle : m_placement->cell_rectangles(cells[i])) {
+                        grid_add_area(box(point(position.x() + rectangle.min_corner().x(), position.y() + rectangle.min_corner().y()),
+                                          point(position.x() + rectangle.max_corner().x(), position.y() + rectangle.max_corner().y())), areas);
+                    }
+                }
+#pragma omp for schedule(static)
+                for (std::size_t index = 0; index < m_grid.size(); index++) {
+                    double area = 0.0;
+                    for (auto & other : thread_areas) {
+                        area += other.empty() ? 0.0 : other[index];
                     }
+                    bin_movable_utilization(m_grid[index], area);
                 }
             }
+        }
 
-            utilizations.resize(bin_count());
+        void density_map::utilizations(std::vector<double> &utilizations, double bin_area_threshold, double free_space_threshold) {
+            m_skipped_bins = 0;
+            utilizations.assign(bin_count(), 0.0);
             for (auto bin : bins_system()) {
                 double current_bin_area = bin_area(bin);
-                if (current_bin_area > max_bin_dimensions.x() * max_bin_dimensions.y() * bin_area_threshold) {
-                    bin_free_space(bin, bin_free_space(bin) - bin_fixed_utilization(bin));
-                    double current_bin_free_space = bin_free_space(bin);
+                if (current_bin_area > m_grid_bin_dimensions.x() * m_grid_bin_dimensions.y() * bin_area_threshold) {
+                    double current_bin_free_space = bin_free_space(bin) - bin_fixed_utilization(bin);
                     if (current_bin_free_space > free_space_threshold * current_bin_area) {
-                        double utilization = bin_movable_utilization(bin) / current_bin_free_space;
-                        utilizations[bin] = utilization;
+                        utilizations[m_bins_system.lookup(bin)] = bin_movable_utilization(bin) / current_bin_free_space;
                     } else {
                         m_skipped_bins++;
                     }
                 }
             }
+        }
+
+        void density_map::build_density_map(point max_bin_dimensions, std::vector<double> &utilizations, double bin_area_threshold, double free_space_threshold) {
+            if (!has_grid()) {
+                build_grid(max_bin_dimensions);
+            }
+            this->utilizations(utilizations, bin_area_threshold, free_space_threshold);
             std::sort(utilizations.begin(), utilizations.end());
         }
     }
@@ -46,10 +46,21 @@ namespace ophidian {
             rtree m_rows_rtree;
 
             unsigned m_skipped_bins;
+
+            // uniform grid of bins, stored row by row
+            point m_grid_origin;
+            point m_grid_bin_dimensions;
+            std::size_t m_grid_columns;
+            std::size_t m_grid_rows;
+            std::vector<entity_system::entity> m_grid;
+
+            void grid_range(const box & region, std::size_t & first_column, std::size_t & last_column, std::size_t & first_row, std::size_t & last_row) const;
+            void grid_add_area(const box & region, double sign, bool fixed);
+            void grid_add_area(const box & region, std::vector<double> & areas);
         public:
 
             density_map(floorplan::floorplan * floorplan, placement::placement * placement)
-                    : m_floorplan(floorplan), m_placement(placement), m_bins(m_bins_system), m_skipped_bins(0) {
+                    : m_floorplan(floorplan), m_placement(placement), m_bins(m_bins_system), m_skipped_bins(0), m_grid_columns(0), m_grid_rows(0) {
                 for (auto row : m_floorplan->rows_system()) {
                     point row_origin = m_floorplan->row_origin(row);
                     point row_dimensions = m_floorplan->row_dimensions(row);
@@ -105,6 +116,45 @@ namespace ophidian {
 
             void intersecting_bins(box region, std::vector<entity_system::entity> & bins);
 
+            /// Builds a uniform grid of bins and fills it with the area of the rows and cells.
+            /**
+             * Bins are max_bin_dimensions wide and tall, except at the chip boundaries. Bins are
+             * found by arithmetic on the grid, so intersecting_bins() and cell_moved() do not
+             * query an R-tree.
+             **/
+            void build_grid(point max_bin_dimensions);
+
+            bool has_grid() const {
+                return !m_grid.empty();
+            }
+
+            entity_system::entity bin_at(point position) const;
+
+            std::size_t grid_columns() const {
+                return m_grid_columns;
+            }
+
+            std::size_t grid_rows() const {
+                return m_grid_rows;
+            }
+
+            entity_system::entity grid_bin(std::size_t column, std::size_t row) const {
+                return m_grid[row * m_grid_columns + column];
+            }
+
+            /// Moves the area of a cell from the bins under old_position to the bins under new_position.
+            void cell_moved(entity_system::entity cell, point old_position, point new_position);
+
+            /// Recomputes the movable utilization of the grid bins from the current cell positions.
+            /**
+            * Meant for when most cells have moved: the cells are split among threads, each one summing
+            * areas in its own copy of the grid, and the copies are added bin by bin in a fixed order.
+            **/
+            void update_movable_utilizations();
+
+            /// Utilization of each bin, indexed by bin; bins that are too small or have too little free space are skipped and left at 0.
+            void utilizations(std::vector<double> & utilizations, double bin_area_threshold = 0.2, double free_space_threshold = 0.2);
+
             void build_density_map(point max_bin_dimensions, std::vector<double> &utilizations, double bin_area_threshold = 0.2, double free_space_threshold = 0.2);
 
             unsigned skipped_bins() { return m_skipped_bins; }
@@ -0,0 +1,307 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#include "electrostatics.h"
+
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+
+namespace ophidian {
+    namespace density {
+
+        namespace {
+
+            using complex = std::complex<double>;
+
+            inline complex multiply(complex a, complex b) {
+                return complex(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+            }
+
+            bool power_of_two(std::size_t value) {
+                return value > 0 && (value & (value - 1)) == 0;
+            }
+
+            // Cosine transforms of length N computed with a radix-2 FFT of length 2N.
+            class cosine_transform {
+                std::size_t m_size;
+                std::vector<std::size_t> m_reversed;
+                std::vector<complex> m_roots; // exp(-2 pi i k / 2N), k < N
+                std::vector<complex> m_shift; // exp(-i pi k / 2N), k < N
+
+                void fft(std::vector<complex> & data, bool inverse) const {
+                    const std::size_t length = 2 * m_size;
+                    for (std::size_t i = 0; i < length; i++) {
+                        if (i < m_reversed[i]) {
+                            std::swap(data[i], data[m_reversed[i]]);
+                        }
+                    }
+                    for (std::size_t span = 2; span <= length; span <<= 1) {
+                        const std::size_t half = span / 2;
+                        const std::size_t step = length / span;
+                        for (std::size_t start = 0; start < length; start += span) {
+                            for (std::size_t k = 0; k < half; k++) {
+                                complex root = inverse ? std::conj(m_roots[k * step]) : m_roots[k * step];
+                                complex even = data[start + k];
+                                complex odd = multiply(data[start + k + half], root);
+                                data[start + k] = even + odd;
+                                data[start + k + half] = even - odd;
+                            }
+                        }
+                    }
+                }
+
+            public:
+                explicit cosine_transform(std::size_t size) : m_size(size), m_reversed(2 * size), m_roots(size), m_shift(size) {
+                    const std::size_t length = 2 * size;
+                    std::size_t bits = 0;
+                    while ((std::size_t(1) << bits) < length) {
+                        bits++;
+                    }
+                    for (std::size_t i = 0; i < length; i++) {
+                        std::size_t reversed = 0;
+                        for (std::size_t bit = 0; bit < bits; bit++) {
+                            if (i & (std::size_t(1) << bit)) {
+                                reversed |= std::size_t(1) << (bits - 1 - bit);
+                            }
+                        }
+                        m_reversed[i] = reversed;
+                    }
+                    for (std::size_t k = 0; k < size; k++) {
+                        m_roots[k] = std::polar(1.0, -2.0 * M_PI * k / length);
+                        m_shift[k] = std::polar(1.0, -M_PI * k / length);
+                    }
+                }
+
+                // out[k] = sum_n in[n] cos(pi k (2n+1) / 2N)
+                void forward(const double * in, double * out, std::vector<complex> & buffer) const {
+                    buffer.assign(2 * m_size, complex(0.0, 0.0));
+                    for (std::size_t n = 0; n < m_size; n++) {
+                        buffer[n] = complex(in[n], 0.0);
+                    }
+                    fft(buffer, false);
+                    for (std::size_t k = 0; k < m_size; k++) {
+                        out[k] = multiply(buffer[k], m_shift[k]).real();
+                    }
+                }
+
+                // cos_out[n] = sum_k in[k] cos(pi k (2n+1) / 2N) and sin_out[n] the same with sin; either may be null
+                void inverse(const double * in, double * cos_out, double * sin_out, std::vector<complex> & buffer) const {
+                    buffer.assign(2 * m_size, complex(0.0, 0.0));
+                    for (std::size_t k = 0; k < m_size; k++) {
+                        buffer[k] = in[k] * std::conj(m_shift[k]);
+                    }
+                    fft(buffer, true);
+                    for (std::size_t n = 0; n < m_size; n++) {
+                        if (cos_out) {
+                            cos_out[n] = buffer[n].real();
+                        }
+                        if (sin_out) {
+                            sin_out[n] = buffer[n].imag();
+                        }
+                    }
+                }
+            };
+
+            void transform_rows(const cosine_transform & transform, std::size_t columns, std::size_t rows, const std::vector<double> & in, std::vector<double> * cos_out, std::vector<double> * sin_out, bool forward) {
+#pragma omp parallel
+                {
+                    std::vector<complex> buffer;
+#pragma omp for schedule(static)
+                    for (std::size_t row = 0; row < rows; row++) {
+                        const double * row_in = in.data() + row * columns;
+                        if (forward) {
+                            transform.forward(row_in, cos_out->data() + row * columns, buffer);
+                        } else {
+                            transform.inverse(row_in, cos_out ? cos_out->data() + row * columns : nullptr, sin_out ? sin_out->data() + row * columns : nullptr, buffer);
+                        }
+                    }
+                }
+            }
+
+            void transform_columns(const cosine_transform & transform, std::size_t columns, std::size_t rows, const std::vector<double> & in, std::vector<double> * cos_out, std::vector<double> * sin_out, bool forward) {
+#pragma omp parallel
+                {
+                    std::vector<complex> buffer;
+                    std::vector<double> column_in(rows), column_cos(rows), column_sin(rows);
+#pragma omp for schedule(static)
+                    for (std::size_t column = 0; column < columns; column++) {
+                        for (std::size_t row = 0; row < rows; row++) {
+                            column_in[row] = in[row * columns + column];
+                        }
+                        if (forward) {
+                            transform.forward(column_in.data(), column_cos.data(), buffer);
+                        } else {
+                            transform.inverse(column_in.data(), cos_out ? column_cos.data() : nullptr, sin_out ? column_sin.data() : nullptr, buffer);
+                        }
+                        for (std::size_t row = 0; row < rows; row++) {
+                            if (cos_out) {
+                                (*cos_out)[row * columns + column] = column_cos[row];
+                            }
+                            if (sin_out) {
+                                (*sin_out)[row * columns + column] = column_sin[row];
+                            }
+                        }
+                    }
+                }
+            }
+
+            std::size_t grid_index(double offset, double bin_size, std::size_t count) {
+                double index = std::floor(offset / bin_size);
+                if (index < 0) {
+                    return 0;
+                }
+                return std::min(static_cast<std::size_t>(index), count - 1);
+            }
+        }
+
+        electrostatics::electrostatics(floorplan::floorplan * floorplan, placement::placement * placement, std::size_t columns, std::size_t rows)
+                : m_placement(placement), m_density(floorplan, placement), m_columns(columns), m_rows(rows), m_energy(0.0) {
+            if (!power_of_two(columns) || !power_of_two(rows)) {
+                throw std::invalid_argument("electrostatics: the number of bins in each direction must be a power of two");
+            }
+            m_origin = floorplan->chip_origin();
+            m_bin_dimensions = point(floorplan->chip_boundaries().x() / columns, floorplan->chip_boundaries().y() / rows);
+            m_density.build_grid(m_bin_dimensions);
+            assert(m_density.grid_columns() == m_columns && m_density.grid_rows() == m_rows);
+
+            m_cells.reserve(placement->netlist().cell_count());
+            for (auto cell : placement->netlist().cell_system()) {
+                m_cells.push_back(cell);
+            }
+
+            m_charge_density.resize(columns * rows);
+            m_potential.resize(columns * rows);
+            m_field_x.resize(columns * rows);
+            m_field_y.resize(columns * rows);
+        }
+
+        void electrostatics::update() {
+            const std::size_t bin_count = m_columns * m_rows;
+            const double bin_area = m_bin_dimensions.x() * m_bin_dimensions.y();
+
+#pragma omp parallel for schedule(static)
+            for (std::size_t row = 0; row < m_rows; row++) {
+                for (std::size_t column = 0; column < m_columns; column++) {
+                    auto bin = m_density.grid_bin(column, row);
+                    m_charge_density[row * m_columns + column] = (m_density.bin_movable_utilization(bin) + m_density.bin_fixed_utilization(bin)) / bin_area;
+                }
+            }
+
+            const cosine_transform row_transform(m_columns);
+            const cosine_transform column_transform(m_rows);
+
+            // a_uv = c_u c_v / (columns rows) sum_xy rho_xy cos(w_u x) cos(w_v y), with c_0 = 1 and c_k = 2
+            std::vector<double> rows_transformed(bin_count), coefficients(bin_count);
+            transform_rows(row_transform, m_columns, m_rows, m_charge_density, &rows_transformed, nullptr, true);
+            transform_columns(column_transform, m_columns, m_rows, rows_transformed, &coefficients, nullptr, true);
+
+            const double width = m_bin_dimensions.x() * m_columns;
+            const double height = m_bin_dimensions.y() * m_rows;
+            std::vector<double> frequency_x(m_columns), frequency_y(m_rows);
+            for (std::size_t u = 0; u < m_columns; u++) {
+                frequency_x[u] = M_PI * u / width;
+            }
+            for (std::size_t v = 0; v < m_rows; v++) {
+                frequency_y[v] = M_PI * v / height;
+            }
+
+            // psi_uv = a_uv / (w_u^2 + w_v^2) solves the Poisson equation with the mean density removed
+            std::vector<double> potential_coefficients(bin_count), field_y_coefficients(bin_count);
+#pragma omp parallel for schedule(static)
+            for (std::size_t v = 0; v < m_rows; v++) {
+                const double scale_v = (v == 0 ? 1.0 : 2.0) / (m_columns * m_rows);
+#pragma omp simd
+                for (std::size_t u = 0; u < m_columns; u++) {
+                    const double scale = (u == 0 ? 1.0 : 2.0) * scale_v;
+                    const double frequency = frequency_x[u] * frequency_x[u] + frequency_y[v] * frequency_y[v];
+                    const double coefficient = (u == 0 && v == 0) ? 0.0 : scale * coefficients[v * m_columns + u] / frequency;
+                    potential_coefficients[v * m_columns + u] = coefficient;
+                    field_y_coefficients[v * m_columns + u] = coefficient * frequency_y[v];
+                }
+            }
+
+            // potential = sum psi_uv cos cos, field_x = sum psi_uv w_u sin(w_u x) cos(w_v y), field_y = sum psi_uv w_v cos(w_u x) sin(w_v y)
+            std::vector<double> potential_columns(bin_count), field_y_columns(bin_count);
+            transform_columns(column_transform, m_columns, m_rows, potential_coefficients, &potential_columns, nullptr, false);
+            transform_columns(column_transform, m_columns, m_rows, field_y_coefficients, nullptr, &field_y_columns, false);
+
+            std::vector<double> field_x_columns(bin_count);
+#pragma omp parallel for schedule(static)
+            for (std::size_t row = 0; row < m_rows; row++) {
+#pragma omp simd
+                for (std::size_t u = 0; u < m_columns; u++) {
+                    field_x_columns[row * m_columns + u] = potential_columns[row * m_columns + u] * frequency_x[u];
+                }
+            }
+            transform_rows(row_transform, m_columns, m_rows, potential_columns, &m_potential, nullptr, false);
+            transform_rows(row_transform, m_columns, m_rows, field_x_columns, nullptr, &m_field_x, false);
+            transform_rows(row_transform, m_columns, m_rows, field_y_columns, &m_field_y, nullptr, false);
+
+            double energy = 0.0;
+#pragma omp parallel for schedule(static) reduction(+:energy)
+            for (std::size_t bin = 0; bin < bin_count; bin++) {
+                energy += m_charge_density[bin] * bin_area * m_potential[bin];
+            }
+            m_energy = 0.5 * energy;
+        }
+
+        void electrostatics::gradients(std::vector<point> &gradients) const {
+            const auto & cell_system = m_placement->netlist().cell_system();
+            gradients.assign(cell_system.size(), point(0.0, 0.0));
+
+#pragma omp parallel for schedule(dynamic, 64)
+            for (std::size_t i = 0; i < m_cells.size(); i++) {
+                auto cell = m_cells[i];
+                if (m_placement->cell_fixed(cell)) {
+                    continue;
+                }
+                double gradient_x = 0.0, gradient_y = 0.0;
+                const point position = m_placement->cell_position(cell);
+                for (auto & rectangle : m_placement->cell_rectangles(cell)) {
+                    const geometry::box<point> cell_box(point(position.x() + rectangle.min_corner().x(), position.y() + rectangle.min_corner().y()),
+                                                        point(position.x() + rectangle.max_corner().x(), position.y() + rectangle.max_corner().y()));
+                    std::size_t first_column = grid_index(cell_box.min_corner().x() - m_origin.x(), m_bin_dimensions.x(), m_columns);
+                    std::size_t last_column = grid_index(cell_box.max_corner().x() - m_origin.x(), m_bin_dimensions.x(), m_columns);
+                    std::size_t first_row = grid_index(cell_box.min_corner().y() - m_origin.y(), m_bin_dimensions.y(), m_rows);
+                    std::size_t last_row = grid_index(cell_box.max_corner().y() - m_origin.y(), m_bin_dimensions.y(), m_rows);
+                    for (std::size_t row = first_row; row <= last_row; row++) {
+                        double bin_y = m_origin.y() + row * m_bin_dimensions.y();
+                        double height = std::min(cell_box.max_corner().y(), bin_y + m_bin_dimensions.y()) - std::max(cell_box.min_corner().y(), bin_y);
+                        if (height <= 0) {
+                            continue;
+                        }
+                        for (std::size_t column = first_column; column <= last_column; column++) {
+                            double bin_x = m_origin.x() + column * m_bin_dimensions.x();
+                            double width = std::min(cell_box.max_corner().x(), bin_x + m_bin_dimensions.x()) - std::max(cell_box.min_corner().x(), bin_x);
+                            if (width <= 0) {
+                                continue;
+                            }
+                            // the energy decreases along the field
+                            gradient_x -= width * height * m_field_x[row * m_columns + column];
+                            gradient_y -= width * height * m_field_y[row * m_columns + column];
+                        }
+                    }
+                }
+                gradients[cell_system.lookup(cell)] = point(gradient_x, gradient_y);
+            }
+        }
+    }
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#ifndef ophidian_ELECTROSTATICS_H
+#define ophidian_ELECTROSTATICS_H
+
+#include "density_map.h"
+
+namespace ophidian {
+    namespace density {
+
+        /// Electrostatic density penalty, as used by analytic placers.
+        /**
+        * Cells are positive charges spread over a power of two grid of bins. The potential of the
+        * charge density is the solution of Poisson's equation with Neumann boundaries, found with
+        * cosine and sine transforms of the grid. The density penalty is the potential energy of
+        * the system and its gradient for a cell is its overlap with each bin times the field there.
+        * From: Lu, Jingwei, et al. "ePlace: Electrostatics-based placement using fast Fourier transform and Nesterov's method." ACM TODAES 20.2 (2015).
+        **/
+        class electrostatics {
+            using point = geometry::point<double>;
+
+            placement::placement * m_placement;
+            density_map m_density;
+
+            std::size_t m_columns;
+            std::size_t m_rows;
+            point m_origin;
+            point m_bin_dimensions;
+
+            std::vector<entity_system::entity> m_cells;
+
+            // grids stored row by row
+            std::vector<double> m_charge_density;
+            std::vector<double> m_potential;
+            std::vector<double> m_field_x;
+            std::vector<double> m_field_y;
+            double m_energy;
+        public:
+
+            /// Builds a columns x rows grid over the chip; both must be powers of two.
+            electrostatics(floorplan::floorplan * floorplan, placement::placement * placement, std::size_t columns, std::size_t rows);
+
+            ~electrostatics() { }
+
+            /// Keeps the bins up to date after a cell has been moved from old_position to new_position.
+            void cell_moved(entity_system::entity cell, point old_position, point new_position) {
+                m_density.cell_moved(cell, old_position, new_position);
+            }
+
+            /// Solves for the potential and the field of the current bins.
+            void update();
+
+            /// Density gradient of each cell, indexed like the netlist cell system; fixed cells get zero.
+            void gradients(std::vector<point> & gradients) const;
+
+            double energy() const {
+                return m_energy;
+            }
+
+            std::size_t columns() const {
+                return m_columns;
+            }
+
+            std::size_t rows() const {
+                return m_rows;
+            }
+
+            const std::vector<double> & charge_density() const {
+                return m_charge_density;
+            }
+
+            const std::vector<double> & potential() const {
+                return m_potential;
+            }
+
+            const std::vector<double> & field_x() const {
+                return m_field_x;
+            }
+
+            const std::vector<double> & field_y() const {
+                return m_field_y;
+            }
+
+            density_map & density() {
+                return m_density;
+            }
+        };
+    }
+}
+
+
+#endif //ophidian_ELECTROSTATICS_H
@@ -147,6 +147,20 @@ public:
         return m_values.end();
     }
 
+    /// Number of values
+    /**
+     * Returns the number of stored values, one per entity of the system.
+     * \return Number of values.
+     */
+    std::size_t size() const {
+        return m_values.size();
+    }
+
+    /// Contiguous storage
+    /**
+     * Returns a pointer to the values, stored contiguously and indexed like the entities.
+     * \return Pointer to the first value.
+     */
     T* data() {
         return m_values.data();
     }
@@ -217,6 +231,10 @@ public:
     std::vector<bool>::const_iterator end() const {
         return m_values.end();
     }
+
+    std::size_t size() const {
+        return m_values.size();
+    }
 };
 
 } /* namespace entity system */
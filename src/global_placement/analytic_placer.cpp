@@ -0,0 +1,412 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#include "analytic_placer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "../density/electrostatics.h"
+
+namespace ophidian {
+namespace global_placement {
+
+namespace {
+
+std::size_t grid_size(std::size_t cells) {
+    std::size_t size = 16;
+    while (size < 1024 && size * size < cells) {
+        size *= 2;
+    }
+    return size;
+}
+
+double dot(const std::vector<double> & a, const std::vector<double> & b) {
+    double result = 0.0;
+#pragma omp parallel for schedule(static) reduction(+:result)
+    for (std::size_t i = 0; i < a.size(); i++) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+}
+
+const std::size_t analytic_placer::fixed_pin;
+
+analytic_placer::analytic_placer(floorplan::floorplan * floorplan, placement::placement * placement)
+    : m_floorplan(floorplan), m_placement(placement), m_chip_origin(floorplan->chip_origin()), m_chip_boundaries(floorplan->chip_boundaries()) {
+    auto & netlist = placement->netlist();
+    auto & library = placement->lib();
+
+    std::vector<std::size_t> cell_index(netlist.cell_system().size(), fixed_pin);
+    m_cells.reserve(netlist.cell_count());
+    for (auto cell : netlist.cell_system()) {
+        if (!placement->cell_fixed(cell)) {
+            cell_index[netlist.cell_system().lookup(cell)] = m_cells.size();
+            m_cells.push_back(cell);
+            m_dimensions.push_back(placement->cell_dimensions(cell));
+            auto position = placement->cell_position(cell);
+            m_x.push_back(position.x());
+            m_y.push_back(position.y());
+        }
+    }
+
+    m_net_begin.reserve(netlist.net_count() + 1);
+    m_net_begin.push_back(0);
+    for (auto net : netlist.net_system()) {
+        auto & pins = netlist.net_pins(net);
+        if (pins.size() < 2) {
+            continue;
+        }
+        for (auto pin : pins) {
+            auto owner = netlist.pin_owner(pin);
+            std::size_t cell = owner == entity_system::invalid_entity ? fixed_pin : cell_index[netlist.cell_system().lookup(owner)];
+            auto offset = cell == fixed_pin ? placement->pin_position(pin) : library.pin_offset(netlist.pin_std_cell(pin));
+            m_pin_cell.push_back(cell);
+            m_pin_x.push_back(offset.x());
+            m_pin_y.push_back(offset.y());
+        }
+        m_net_begin.push_back(m_pin_cell.size());
+    }
+
+    m_cell_pin_begin.assign(m_cells.size() + 1, 0);
+    for (auto cell : m_pin_cell) {
+        if (cell != fixed_pin) {
+            m_cell_pin_begin[cell + 1]++;
+        }
+    }
+    for (std::size_t cell = 0; cell < m_cells.size(); cell++) {
+        m_cell_pin_begin[cell + 1] += m_cell_pin_begin[cell];
+    }
+    m_cell_pins.resize(m_cell_pin_begin.back());
+    std::vector<std::size_t> next(m_cell_pin_begin.begin(), m_cell_pin_begin.end() - 1);
+    for (std::size_t pin = 0; pin < m_pin_cell.size(); pin++) {
+        if (m_pin_cell[pin] != fixed_pin) {
+            m_cell_pins[next[m_pin_cell[pin]]++] = pin;
+        }
+    }
+}
+
+void analytic_placer::bound_to_bound_system(bool horizontal, std::vector<triplet> & triplets, std::vector<double> & b) const {
+    auto & rows = m_floorplan->rows_system();
+    const double minimum_distance = rows.size() == 0 ? 1.0 : m_floorplan->site_dimensions(m_floorplan->row_site(*rows.begin())).x();
+    auto coordinate = [this, horizontal](std::size_t pin) {
+        return horizontal ? pin_x(pin) : pin_y(pin);
+    };
+    auto offset = [this, horizontal](std::size_t pin) {
+        return horizontal ? m_pin_x[pin] : m_pin_y[pin];
+    };
+
+    triplets.clear();
+    b.assign(m_cells.size(), 0.0);
+    auto connect = [&](std::size_t a, std::size_t c, double weight) {
+        std::size_t cell_a = m_pin_cell[a];
+        std::size_t cell_c = m_pin_cell[c];
+        if (cell_a == cell_c) {
+            return;
+        }
+        if (cell_a != fixed_pin && cell_c != fixed_pin) {
+            triplets.push_back({cell_a, cell_a, weight});
+            triplets.push_back({cell_c, cell_c, weight});
+            triplets.push_back({cell_a, cell_c, -weight});
+            triplets.push_back({cell_c, cell_a, -weight});
+            b[cell_a] -= weight * (offset(a) - offset(c));
+            b[cell_c] += weight * (offset(a) - offset(c));
+        } else if (cell_a != fixed_pin) {
+            triplets.push_back({cell_a, cell_a, weight});
+            b[cell_a] += weight * (offset(c) - offset(a));
+        } else {
+            triplets.push_back({cell_c, cell_c, weight});
+            b[cell_c] += weight * (offset(a) - offset(c));
+        }
+    };
+
+    for (std::size_t net = 0; net + 1 < m_net_begin.size(); net++) {
+        std::size_t begin = m_net_begin[net];
+        std::size_t end = m_net_begin[net + 1];
+        std::size_t lower = begin, upper = begin;
+        for (std::size_t pin = begin + 1; pin < end; pin++) {
+            if (coordinate(pin) < coordinate(lower)) {
+                lower = pin;
+            }
+            if (coordinate(pin) > coordinate(upper)) {
+                upper = pin;
+            }
+        }
+        if (lower == upper) {
+            upper = lower == begin ? begin + 1 : begin;
+        }
+        const double scale = 2.0 / (end - begin - 1);
+        auto weight = [&](std::size_t a, std::size_t c) {
+            return scale / std::max(std::abs(coordinate(a) - coordinate(c)), minimum_distance);
+        };
+        connect(lower, upper, weight(lower, upper));
+        for (std::size_t pin = begin; pin < end; pin++) {
+            if (pin != lower && pin != upper) {
+                connect(pin, lower, weight(pin, lower));
+                connect(pin, upper, weight(pin, upper));
+            }
+        }
+    }
+
+    // a weak anchor at the current positions keeps the system positive definite for cells without fixed connections
+    double total = 0.0;
+    for (auto & entry : triplets) {
+        if (entry.row == entry.column) {
+            total += entry.value;
+        }
+    }
+    const double anchor = m_cells.empty() || total == 0.0 ? 1.0 : 1e-3 * total / m_cells.size();
+    auto & positions = horizontal ? m_x : m_y;
+    for (std::size_t cell = 0; cell < m_cells.size(); cell++) {
+        triplets.push_back({cell, cell, anchor});
+        b[cell] += anchor * positions[cell];
+    }
+}
+
+void analytic_placer::quadratic_placement(std::size_t iterations) {
+    std::vector<triplet> triplets;
+    std::vector<double> b;
+    for (std::size_t iteration = 0; iteration < iterations; iteration++) {
+        auto start = std::chrono::steady_clock::now();
+        bound_to_bound_system(true, triplets, b);
+        conjugate_gradient(sparse_matrix(m_cells.size(), triplets), b, m_x);
+        bound_to_bound_system(false, triplets, b);
+        conjugate_gradient(sparse_matrix(m_cells.size(), triplets), b, m_y);
+#pragma omp parallel for schedule(static)
+        for (std::size_t cell = 0; cell < m_cells.size(); cell++) {
+            clamp_to_chip(cell);
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        m_report.push_back({m_report.size(), hpwl(), 1.0, elapsed.count()});
+    }
+    write_positions();
+}
+
+double analytic_placer::weighted_average_gradient(double gamma, std::vector<double> & gradient_x, std::vector<double> & gradient_y) const {
+    std::vector<double> pin_gradient_x(m_pin_cell.size()), pin_gradient_y(m_pin_cell.size());
+    double wirelength = 0.0;
+#pragma omp parallel for schedule(dynamic, 256) reduction(+:wirelength)
+    for (std::size_t net = 0; net < m_net_begin.size() - 1; net++) {
+        const std::size_t begin = m_net_begin[net];
+        const std::size_t end = m_net_begin[net + 1];
+        for (int dimension = 0; dimension < 2; dimension++) {
+            auto coordinate = [this, dimension](std::size_t pin) {
+                return dimension == 0 ? pin_x(pin) : pin_y(pin);
+            };
+            auto & pin_gradient = dimension == 0 ? pin_gradient_x : pin_gradient_y;
+            double maximum = coordinate(begin), minimum = coordinate(begin);
+            for (std::size_t pin = begin + 1; pin < end; pin++) {
+                maximum = std::max(maximum, coordinate(pin));
+                minimum = std::min(minimum, coordinate(pin));
+            }
+            // exponentials are shifted by the extremes so they never overflow
+            double sum_upper = 0.0, weighted_upper = 0.0, sum_lower = 0.0, weighted_lower = 0.0;
+            for (std::size_t pin = begin; pin < end; pin++) {
+                const double value = coordinate(pin);
+                const double upper = std::exp((value - maximum) / gamma);
+                const double lower = std::exp((minimum - value) / gamma);
+                sum_upper += upper;
+                weighted_upper += value * upper;
+                sum_lower += lower;
+                weighted_lower += value * lower;
+            }
+            const double average_upper = weighted_upper / sum_upper;
+            const double average_lower = weighted_lower / sum_lower;
+            wirelength += average_upper - average_lower;
+            for (std::size_t pin = begin; pin < end; pin++) {
+                const double value = coordinate(pin);
+                const double upper = std::exp((value - maximum) / gamma) / sum_upper * (1.0 + (value - average_upper) / gamma);
+                const double lower = std::exp((minimum - value) / gamma) / sum_lower * (1.0 - (value - average_lower) / gamma);
+                pin_gradient[pin] = upper - lower;
+            }
+        }
+    }
+
+    gradient_x.resize(m_cells.size());
+    gradient_y.resize(m_cells.size());
+#pragma omp parallel for schedule(static)
+    for (std::size_t cell = 0; cell < m_cells.size(); cell++) {
+        double x = 0.0, y = 0.0;
+        for (std::size_t index = m_cell_pin_begin[cell]; index < m_cell_pin_begin[cell + 1]; index++) {
+            x += pin_gradient_x[m_cell_pins[index]];
+            y += pin_gradient_y[m_cell_pins[index]];
+        }
+        gradient_x[cell] = x;
+        gradient_y[cell] = y;
+    }
+    return wirelength;
+}
+
+void analytic_placer::nonlinear_placement(double target_overflow, std::size_t max_iterations, std::size_t bins) {
+    if (m_cells.empty()) {
+        return;
+    }
+    if (bins == 0) {
+        bins = grid_size(m_cells.size());
+    }
+    write_positions();
+    density::electrostatics electrostatics(m_floorplan, m_placement, bins, bins);
+    auto & density = electrostatics.density();
+    auto & cell_system = m_placement->netlist().cell_system();
+    const double bin_width = m_chip_boundaries.x() / bins;
+
+    std::vector<std::size_t> system_index(m_cells.size());
+    std::vector<double> area(m_cells.size());
+    double movable_area = 0.0;
+    for (std::size_t cell = 0; cell < m_cells.size(); cell++) {
+        system_index[cell] = cell_system.lookup(m_cells[cell]);
+        area[cell] = m_dimensions[cell].x() * m_dimensions[cell].y();
+        movable_area += area[cell];
+    }
+
+    auto overflow = [&]() {
+        double total = 0.0;
+        for (std::size_t row = 0; row < density.grid_rows(); row++) {
+            for (std::size_t column = 0; column < density.grid_columns(); column++) {
+                auto bin = density.grid_bin(column, row);
+                total += std::max(0.0, density.bin_movable_utilization(bin) - std::max(0.0, density.bin_free_space(bin) - density.bin_fixed_utilization(bin)));
+            }
+        }
+        return total / movable_area;
+    };
+
+    const std::size_t n = m_cells.size();
+    std::vector<double> wirelength_x, wirelength_y;
+    std::vector<geometry::point<double>> density_gradient;
+    std::vector<double> gradient(2 * n), preconditioned(2 * n), previous_gradient(2 * n), previous_preconditioned(2 * n), direction(2 * n, 0.0), displacement(2 * n);
+    double lambda = 0.0;
+    double tau = overflow();
+
+    for (std::size_t iteration = 0; iteration < max_iterations && tau > target_overflow; iteration++) {
+        auto start = std::chrono::steady_clock::now();
+        const double gamma = 8.0 * bin_width * std::pow(10.0, (20.0 / 9.0) * tau - 11.0 / 9.0);
+        weighted_average_gradient(gamma, wirelength_x, wirelength_y);
+        electrostatics.update();
+        electrostatics.gradients(density_gradient);
+
+        if (iteration == 0) {
+            double wirelength_norm = 0.0, density_norm = 0.0;
+            for (std::size_t cell = 0; cell < n; cell++) {
+                wirelength_norm += std::abs(wirelength_x[cell]) + std::abs(wirelength_y[cell]);
+                density_norm += std::abs(density_gradient[system_index[cell]].x()) + std::abs(density_gradient[system_index[cell]].y());
+            }
+            lambda = density_norm > 0.0 ? wirelength_norm / density_norm : 1.0;
+        }
+
+#pragma omp parallel for schedule(static)
+        for (std::size_t cell = 0; cell < n; cell++) {
+            auto & density_cell = density_gradient[system_index[cell]];
+            gradient[2 * cell] = wirelength_x[cell] + lambda * density_cell.x();
+            gradient[2 * cell + 1] = wirelength_y[cell] + lambda * density_cell.y();
+            const double hessian = std::max(1.0, static_cast<double>(m_cell_pin_begin[cell + 1] - m_cell_pin_begin[cell]) + lambda * area[cell]);
+            preconditioned[2 * cell] = gradient[2 * cell] / hessian;
+            preconditioned[2 * cell + 1] = gradient[2 * cell + 1] / hessian;
+        }
+
+        // Polak-Ribiere direction, restarted when the coefficient turns negative
+        double beta = 0.0;
+        double step_estimate = 0.0;
+        if (iteration > 0) {
+            const double denominator = dot(previous_preconditioned, previous_gradient);
+            if (denominator > 0.0) {
+                beta = std::max(0.0, (dot(preconditioned, gradient) - dot(preconditioned, previous_gradient)) / denominator);
+            }
+            // Barzilai-Borwein estimate of the inverse curvature along the last displacement
+            const double curvature = dot(displacement, preconditioned) - dot(displacement, previous_preconditioned);
+            if (curvature > 0.0) {
+                step_estimate = dot(displacement, displacement) / curvature;
+            }
+        }
+        double squared_length = 0.0;
+#pragma omp parallel for schedule(static) reduction(+:squared_length)
+        for (std::size_t i = 0; i < 2 * n; i++) {
+            direction[i] = -preconditioned[i] + beta * direction[i];
+            squared_length += direction[i] * direction[i];
+        }
+        previous_gradient.swap(gradient);
+        previous_preconditioned.swap(preconditioned);
+
+        // cells move by at most a bin on average, and by half a bin on the first step
+        const double rms = std::sqrt(squared_length / n);
+        double step = 0.0;
+        if (rms > 0.0) {
+            step = step_estimate > 0.0 ? std::min(step_estimate, bin_width / rms) : 0.5 * bin_width / rms;
+        }
+        // every cell moves, so the bins are summed again once instead of moving each cell's area
+#pragma omp parallel for schedule(static)
+        for (std::size_t cell = 0; cell < n; cell++) {
+            const double old_x = m_x[cell], old_y = m_y[cell];
+            m_x[cell] += step * direction[2 * cell];
+            m_y[cell] += step * direction[2 * cell + 1];
+            clamp_to_chip(cell);
+            displacement[2 * cell] = m_x[cell] - old_x;
+            displacement[2 * cell + 1] = m_y[cell] - old_y;
+            m_placement->cell_position(m_cells[cell], geometry::point<double>(m_x[cell], m_y[cell]));
+        }
+        density.update_movable_utilizations();
+
+        tau = overflow();
+        lambda *= 1.05;
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        m_report.push_back({m_report.size(), hpwl(), tau, elapsed.count()});
+    }
+}
+
+void analytic_placer::place() {
+    // start from the chip center, as the first bound-to-bound model has no positions to weigh
+    for (std::size_t cell = 0; cell < m_cells.size(); cell++) {
+        m_x[cell] = (m_chip_origin.x() + m_chip_boundaries.x() - m_dimensions[cell].x()) / 2.0;
+        m_y[cell] = (m_chip_origin.y() + m_chip_boundaries.y() - m_dimensions[cell].y()) / 2.0;
+    }
+    quadratic_placement();
+    nonlinear_placement();
+}
+
+double analytic_placer::hpwl() const {
+    double total = 0.0;
+#pragma omp parallel for schedule(dynamic, 256) reduction(+:total)
+    for (std::size_t net = 0; net < m_net_begin.size() - 1; net++) {
+        const std::size_t begin = m_net_begin[net];
+        double min_x = pin_x(begin), max_x = min_x, min_y = pin_y(begin), max_y = min_y;
+        for (std::size_t pin = begin + 1; pin < m_net_begin[net + 1]; pin++) {
+            min_x = std::min(min_x, pin_x(pin));
+            max_x = std::max(max_x, pin_x(pin));
+            min_y = std::min(min_y, pin_y(pin));
+            max_y = std::max(max_y, pin_y(pin));
+        }
+        total += (max_x - min_x) + (max_y - min_y);
+    }
+    return total;
+}
+
+void analytic_placer::clamp_to_chip(std::size_t cell) {
+    m_x[cell] = std::min(std::max(m_x[cell], m_chip_origin.x()), m_chip_boundaries.x() - m_dimensions[cell].x());
+    m_y[cell] = std::min(std::max(m_y[cell], m_chip_origin.y()), m_chip_boundaries.y() - m_dimensions[cell].y());
+}
+
+void analytic_placer::write_positions() {
+    for (std::size_t cell = 0; cell < m_cells.size(); cell++) {
+        m_placement->cell_position(m_cells[cell], geometry::point<double>(m_x[cell], m_y[cell]));
+    }
+}
+
+}
+}
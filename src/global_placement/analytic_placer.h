@@ -0,0 +1,117 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#ifndef OPHIDIAN_GLOBAL_PLACEMENT_ANALYTIC_PLACER_H
+#define OPHIDIAN_GLOBAL_PLACEMENT_ANALYTIC_PLACER_H
+
+#include <limits>
+#include "../placement/placement.h"
+#include "../floorplan/floorplan.h"
+#include "conjugate_gradient.h"
+
+namespace ophidian {
+namespace global_placement {
+
+/// Statistics of one global placement iteration; quadratic iterations do not measure density and report an overflow of 1.
+struct iteration_report {
+    std::size_t iteration;
+    double hpwl;
+    double overflow;
+    double milliseconds;
+};
+
+/// Analytic global placer.
+/**
+ * quadratic_placement() minimizes the quadratic wirelength of the bound-to-bound net model, solving the
+ * x and y systems with the sparse conjugate gradient method. nonlinear_placement() then minimizes the
+ * weighted-average wirelength plus the electrostatic density penalty with the nonlinear conjugate
+ * gradient method, until the density overflow reaches its target. Cells are left overlapping and off
+ * the sites, to be legalized afterwards, e.g. by legalization::abacus::abacus.
+ * From: Spindler, Peter, et al. "Kraftwerk2 - a fast force-directed quadratic placement approach using an accurate net model." IEEE TCAD 27.8 (2008).
+ * and Lu, Jingwei, et al. "ePlace: Electrostatics-based placement using fast Fourier transform and Nesterov's method." ACM TODAES 20.2 (2015).
+ */
+class analytic_placer {
+    using point = geometry::point<double>;
+    static const std::size_t fixed_pin = std::numeric_limits<std::size_t>::max();
+
+    floorplan::floorplan * m_floorplan;
+    placement::placement * m_placement;
+
+    point m_chip_origin;
+    point m_chip_boundaries;
+
+    // movable cells are the variables, positions are their lower left corners
+    std::vector<entity_system::entity> m_cells;
+    std::vector<point> m_dimensions;
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+
+    // pins grouped by net; a pin refers to a movable cell and its offset from the corner,
+    // or holds the position of a fixed pin
+    std::vector<std::size_t> m_net_begin;
+    std::vector<std::size_t> m_pin_cell;
+    std::vector<double> m_pin_x;
+    std::vector<double> m_pin_y;
+
+    // pins of each movable cell, as indices in the pins above
+    std::vector<std::size_t> m_cell_pin_begin;
+    std::vector<std::size_t> m_cell_pins;
+
+    std::vector<iteration_report> m_report;
+
+    double pin_x(std::size_t pin) const {
+        return m_pin_cell[pin] == fixed_pin ? m_pin_x[pin] : m_x[m_pin_cell[pin]] + m_pin_x[pin];
+    }
+
+    double pin_y(std::size_t pin) const {
+        return m_pin_cell[pin] == fixed_pin ? m_pin_y[pin] : m_y[m_pin_cell[pin]] + m_pin_y[pin];
+    }
+
+    void bound_to_bound_system(bool horizontal, std::vector<triplet> & triplets, std::vector<double> & b) const;
+    double weighted_average_gradient(double gamma, std::vector<double> & gradient_x, std::vector<double> & gradient_y) const;
+    void clamp_to_chip(std::size_t cell);
+    void write_positions();
+public:
+    analytic_placer(floorplan::floorplan * floorplan, placement::placement * placement);
+
+    /// Quadratic placement; each iteration rebuilds the net model from the current positions.
+    void quadratic_placement(std::size_t iterations = 5);
+
+    /// Wirelength and density driven placement on a bins x bins grid; bins = 0 picks a grid from the number of cells.
+    void nonlinear_placement(double target_overflow = 0.1, std::size_t max_iterations = 1000, std::size_t bins = 0);
+
+    /// quadratic_placement() followed by nonlinear_placement().
+    void place();
+
+    double hpwl() const;
+
+    std::size_t movable_cell_count() const {
+        return m_cells.size();
+    }
+
+    const std::vector<iteration_report> & report() const {
+        return m_report;
+    }
+};
+
+}
+}
+
+#endif // OPHIDIAN_GLOBAL_PLACEMENT_ANALYTIC_PLACER_H
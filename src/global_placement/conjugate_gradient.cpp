@@ -0,0 +1,149 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#include "conjugate_gradient.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ophidian {
+namespace global_placement {
+
+sparse_matrix::sparse_matrix(std::size_t size, const std::vector<triplet> &triplets) :
+    m_size(size),
+    m_row_begin(size + 1, 0)
+{
+    // bucket the triplets by row, then sort and merge the columns of each row
+    std::vector<std::size_t> row_count(size + 1, 0);
+    for(auto & entry : triplets)
+        ++row_count[entry.row + 1];
+    for(std::size_t row = 0; row < size; ++row)
+        row_count[row + 1] += row_count[row];
+    std::vector< std::pair<std::size_t, double> > bucketed(triplets.size());
+    std::vector<std::size_t> next(row_count.begin(), row_count.end() - 1);
+    for(auto & entry : triplets)
+        bucketed[next[entry.row]++] = std::make_pair(entry.column, entry.value);
+
+    m_columns.reserve(triplets.size());
+    m_values.reserve(triplets.size());
+    for(std::size_t row = 0; row < size; ++row)
+    {
+        auto begin = bucketed.begin() + row_count[row];
+        auto end = bucketed.begin() + row_count[row + 1];
+        std::sort(begin, end, [](const std::pair<std::size_t, double> & a, const std::pair<std::size_t, double> & b) {
+            return a.first < b.first;
+        });
+        m_row_begin[row] = m_values.size();
+        for(auto it = begin; it != end; ++it)
+        {
+            if(m_values.size() > m_row_begin[row] && m_columns.back() == it->first)
+                m_values.back() += it->second;
+            else
+            {
+                m_columns.push_back(it->first);
+                m_values.push_back(it->second);
+            }
+        }
+    }
+    m_row_begin[size] = m_values.size();
+}
+
+void sparse_matrix::multiply(const std::vector<double> &x, std::vector<double> &result) const
+{
+    result.resize(m_size);
+#pragma omp parallel for schedule(static)
+    for(std::size_t row = 0; row < m_size; ++row)
+    {
+        double sum = 0.0;
+        for(std::size_t i = m_row_begin[row]; i < m_row_begin[row + 1]; ++i)
+            sum += m_values[i] * x[m_columns[i]];
+        result[row] = sum;
+    }
+}
+
+void sparse_matrix::diagonal(std::vector<double> &result) const
+{
+    result.assign(m_size, 0.0);
+    for(std::size_t row = 0; row < m_size; ++row)
+        for(std::size_t i = m_row_begin[row]; i < m_row_begin[row + 1]; ++i)
+            if(m_columns[i] == row)
+                result[row] = m_values[i];
+}
+
+namespace {
+
+double dot(const std::vector<double> & a, const std::vector<double> & b)
+{
+    double sum = 0.0;
+#pragma omp parallel for schedule(static) reduction(+:sum)
+    for(std::size_t i = 0; i < a.size(); ++i)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+}
+
+std::size_t conjugate_gradient(const sparse_matrix &A, const std::vector<double> &b, std::vector<double> &x, double tolerance, std::size_t max_iterations)
+{
+    const std::size_t size = A.size();
+    x.resize(size, 0.0);
+
+    std::vector<double> inverse_diagonal;
+    A.diagonal(inverse_diagonal);
+    for(auto & value : inverse_diagonal)
+        value = value != 0.0 ? 1.0 / value : 1.0;
+
+    std::vector<double> residual(size), preconditioned(size), direction(size), product(size);
+    A.multiply(x, product);
+#pragma omp parallel for schedule(static)
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        residual[i] = b[i] - product[i];
+        preconditioned[i] = inverse_diagonal[i] * residual[i];
+        direction[i] = preconditioned[i];
+    }
+
+    const double threshold = tolerance * tolerance * std::max(dot(b, b), 1e-300);
+    double rho = dot(residual, preconditioned);
+    std::size_t iteration = 0;
+    while(iteration < max_iterations && dot(residual, residual) > threshold)
+    {
+        A.multiply(direction, product);
+        double alpha = rho / dot(direction, product);
+#pragma omp parallel for schedule(static)
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            x[i] += alpha * direction[i];
+            residual[i] -= alpha * product[i];
+            preconditioned[i] = inverse_diagonal[i] * residual[i];
+        }
+        double next_rho = dot(residual, preconditioned);
+        double beta = next_rho / rho;
+        rho = next_rho;
+#pragma omp parallel for schedule(static)
+        for(std::size_t i = 0; i < size; ++i)
+            direction[i] = preconditioned[i] + beta * direction[i];
+        ++iteration;
+    }
+    return iteration;
+}
+
+}
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#ifndef OPHIDIAN_GLOBAL_PLACEMENT_CONJUGATE_GRADIENT_H
+#define OPHIDIAN_GLOBAL_PLACEMENT_CONJUGATE_GRADIENT_H
+
+#include <vector>
+#include <cstddef>
+
+namespace ophidian {
+/// Global placement algorithms
+namespace global_placement {
+
+/// Entry of a sparse matrix under construction.
+struct triplet {
+    std::size_t row;
+    std::size_t column;
+    double value;
+};
+
+/// Sparse matrix in compressed sparse row format.
+class sparse_matrix {
+    std::size_t m_size;
+    std::vector<std::size_t> m_row_begin;
+    std::vector<std::size_t> m_columns;
+    std::vector<double> m_values;
+public:
+    /// Builds a size x size matrix from triplets; entries with the same row and column are added up.
+    sparse_matrix(std::size_t size, const std::vector<triplet> & triplets);
+
+    std::size_t size() const {
+        return m_size;
+    }
+
+    std::size_t non_zeros() const {
+        return m_values.size();
+    }
+
+    /// result = A x
+    void multiply(const std::vector<double> & x, std::vector<double> & result) const;
+
+    void diagonal(std::vector<double> & result) const;
+};
+
+/// Solves A x = b for a symmetric positive definite A with the Jacobi preconditioned conjugate gradient method.
+/**
+ * x holds the initial guess and receives the solution. Iterations stop when the residual norm is below
+ * tolerance times the norm of b.
+ * \return Number of iterations.
+ */
+std::size_t conjugate_gradient(const sparse_matrix & A, const std::vector<double> & b, std::vector<double> & x, double tolerance = 1e-6, std::size_t max_iterations = 1000);
+
+}
+}
+
+#endif // OPHIDIAN_GLOBAL_PLACEMENT_CONJUGATE_GRADIENT_H
@@ -20,6 +20,8 @@
 #endif
 
 #include <algorithm>
+#include <mutex>
+#include <vector>
 using std::max;
 using std::min;
 using std::pair;
@@ -79,12 +81,12 @@ namespace ophidian {
         DTYPE wirelength(tree t);
         void printtree(tree t);
 
-        void readLUT()
-        {
-            static bool LUTread = false;
-            if(LUTread) return;
-            LUTread = true;
+        // The tables are written once, by the first call of readLUT(), and are
+        // only read afterwards, so every thread shares them without locking.
+        static std::once_flag LUT_loaded;
 
+        static void loadLUT()
+        {
             FILE *fpwv, *fprt;
             struct csoln *p;
             int d, i, j, k, kk, ns, nn, ne;
@@ -181,15 +183,47 @@ namespace ophidian {
             }
         }
 
+        void readLUT()
+        {
+            std::call_once(LUT_loaded, loadLUT);
+        }
+
+        // Sorting buffers of flute() and flute_wl(). Each thread keeps its own,
+        // grown on demand, instead of allocating them on every call.
+        struct flute_scratch {
+            std::vector<DTYPE> xs, ys;
+            std::vector<int> s;
+            std::vector<POINT> pt;
+            std::vector<POINTptr> ptp;
+
+            void reserve(unsigned size) {
+                if (xs.size() >= size)
+                    return;
+                xs.resize(size);
+                ys.resize(size);
+                s.resize(size);
+                pt.resize(size);
+                ptp.resize(size);
+            }
+        };
+
+        static flute_scratch & thread_scratch(unsigned size)
+        {
+            static thread_local flute_scratch scratch;
+            scratch.reserve(size);
+            return scratch;
+        }
+
         DTYPE flute_wl(int d, DTYPE x[], DTYPE y[], int acc)
         {
             unsigned allocateSize = MAXD;
             if (d > MAXD)
                 allocateSize = d+1;
-            DTYPE*  xs  = (DTYPE*)  malloc(sizeof(DTYPE)*allocateSize);
-            DTYPE*  ys  = (DTYPE*)  malloc(sizeof(DTYPE)*allocateSize);
-            int*     s  = (int*)    malloc(sizeof(int)*allocateSize);
-            POINT*  pt  = (POINT*)  malloc(sizeof(POINT)*allocateSize);
+            flute_scratch & scratch = thread_scratch(allocateSize);
+            DTYPE*  xs  = scratch.xs.data();
+            DTYPE*  ys  = scratch.ys.data();
+            int*     s  = scratch.s.data();
+            POINT*  pt  = scratch.pt.data();
             /* replaced the selection sort with stl stable_sort. mckim
           POINTptr *ptp = (POINTptr*) malloc(sizeof(POINTptr)*allocateSize); */
             POINT* tmpp;
@@ -295,11 +329,6 @@ namespace ophidian {
 
                 l = flutes_wl(d, xs, ys, s, acc);
             }
-            free(xs);
-            free(ys);
-            free(s);
-            free(pt);
-//  free(ptp);
             return l;
         }
 
@@ -694,11 +723,12 @@ namespace ophidian {
                 allocateSize = d+1;
 //    printf("setting allocateSize = %d\n", allocateSize);
             }
-            DTYPE  *xs  = (DTYPE*)      malloc(sizeof(DTYPE)*allocateSize);
-            DTYPE  *ys  = (DTYPE*)      malloc(sizeof(DTYPE)*allocateSize);
-            int    *s   = (int*)        malloc(sizeof(int)*allocateSize);
-            POINT  *pt  = (POINT*)      malloc(sizeof(POINT)*allocateSize);
-            POINTptr *ptp = (POINTptr*) malloc(sizeof(POINTptr)*allocateSize);
+            flute_scratch & scratch = thread_scratch(allocateSize);
+            DTYPE  *xs  = scratch.xs.data();
+            DTYPE  *ys  = scratch.ys.data();
+            int    *s   = scratch.s.data();
+            POINT  *pt  = scratch.pt.data();
+            POINTptr *ptp = scratch.ptp.data();
 
             POINT* tmpp;
             DTYPE minval;
@@ -776,11 +806,6 @@ namespace ophidian {
 
                 t = flutes(d, xs, ys, s, acc);
             }
-            free(xs);
-            free(ys);
-            free(s);
-            free(pt);
-            free(ptp);
             return t;
         }
 
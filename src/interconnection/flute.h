@@ -35,7 +35,7 @@ namespace ophidian {
         };
 
         // Major functions
-        extern void readLUT();
+        extern void readLUT(); // loads the tables on the first call, safe to call from any thread
         extern DTYPE flute_wl(int d, DTYPE x[], DTYPE y[], int acc);
 //Macro: DTYPE flutes_wl(int d, DTYPE xs[], DTYPE ys[], int s[], int acc);
         extern tree flute(int d, DTYPE x[], DTYPE y[], int acc);
@@ -58,8 +58,10 @@ rc_tree &rc_tree::operator=(const rc_tree &other)
     for(lemon::ListGraph::NodeIt it(m_graph); it != lemon::INVALID; ++it)
         m_name2node[m_names[it]] = it;
 
+    m_taps.clear();
     for(auto tap : other.m_taps)
         m_taps.push_back(nr[tap]);
+    m_tap_pins = other.m_tap_pins;
 
     return *this;
 }
@@ -70,6 +72,13 @@ rc_tree::~rc_tree() {
 void rc_tree::tap_insert(rc_tree::capacitor_id cap)
 {
     m_taps.push_back(cap);
+    m_tap_pins.push_back(entity_system::invalid_entity);
+}
+
+void rc_tree::tap_insert(rc_tree::capacitor_id cap, entity_system::entity pin)
+{
+    m_taps.push_back(cap);
+    m_tap_pins.push_back(pin);
 }
 
 packed_rc_tree rc_tree::pack(capacitor_id source) const
@@ -124,8 +133,16 @@ packed_rc_tree rc_tree::pack(capacitor_id source) const
             result.pred(current_order, order[parent]);
         }
     }
-    for(auto tap : m_taps)
-        result.tap(m_names[tap], order[tap]);
+    std::vector< std::pair<entity_system::entity, std::size_t> > pin_taps;
+    for(std::size_t i = 0; i < m_taps.size(); ++i)
+    {
+        result.tap(m_names[m_taps[i]], order[m_taps[i]]);
+        if(!(m_tap_pins[i] == entity_system::invalid_entity))
+            pin_taps.push_back(std::make_pair(m_tap_pins[i], order[m_taps[i]]));
+    }
+    std::sort(pin_taps.begin(), pin_taps.end());
+    for(auto & pin_tap : pin_taps)
+        result.tap(pin_tap.first, pin_tap.second);
     return result;
 }
 
@@ -156,8 +173,7 @@ void rc_tree::capacitance(lemon::ListGraph::Node u,
 
 packed_rc_tree::packed_rc_tree(std::size_t node_count) :
     m_pred(node_count, -1),
-    m_resistances(node_count),
-    m_capacitances(node_count)
+    m_values(2*node_count, 0.0)
 {
 
 }
@@ -174,12 +190,12 @@ void packed_rc_tree::pred(std::size_t i, std::size_t pred)
 
 void packed_rc_tree::capacitance(std::size_t i, quantity<si::capacitance> cap)
 {
-    m_capacitances[i] = cap;
+    m_values[node_count()+i] = cap.value();
 }
 
 void packed_rc_tree::resistance(std::size_t i, quantity<si::resistance> res)
 {
-    m_resistances[i] = res;
+    m_values[i] = res.value();
 }
 
 void packed_rc_tree::tap(const std::string &name, std::size_t value)
@@ -187,6 +203,15 @@ void packed_rc_tree::tap(const std::string &name, std::size_t value)
     m_taps[name] = value;
 }
 
+void packed_rc_tree::tap(entity_system::entity pin, std::size_t value)
+{
+    auto position = std::lower_bound(m_pin_taps.begin(), m_pin_taps.end(), std::make_pair(pin, std::size_t(0)));
+    if(position != m_pin_taps.end() && position->first == pin)
+        position->second = value;
+    else
+        m_pin_taps.insert(position, std::make_pair(pin, value));
+}
+
 } /* namespace timing */
 } /* namespace ophidian */
 
@@ -28,6 +28,10 @@ under the License.
 #include <lemon/maps.h>
 
 #include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+
+#include "../entity_system/entity.h"
 
 namespace ophidian {
 /// The Interonnection namespace.
@@ -36,11 +40,19 @@ namespace interconnection {
 using namespace boost::units;
 
 /// Packed RC Tree Class.
+/**
+ * Capacitors are numbered in breadth-first order from the source, so the
+ * parent of a capacitor always has a smaller index. Resistances (in ohms, the
+ * resistance of capacitor i is the one to its parent) and capacitances (in
+ * farads) are stored as plain doubles in a single contiguous block, which the
+ * wire delay kernels read directly. Taps can be found by capacitor name or,
+ * when the tree was built with pins, by pin entity.
+ */
 class packed_rc_tree {
     std::vector< std::size_t > m_pred;
-    std::vector< quantity<si::resistance> > m_resistances;
-    std::vector< quantity<si::capacitance> > m_capacitances;
+    std::vector< double > m_values; // resistances followed by capacitances
     std::unordered_map<std::string, std::size_t> m_taps;
+    std::vector< std::pair<entity_system::entity, std::size_t> > m_pin_taps; // sorted by pin
 
 public:
     packed_rc_tree(std::size_t node_count=0);
@@ -55,18 +67,41 @@ public:
         return m_pred[i];
     }
     quantity<si::resistance> resistance(std::size_t i) const {
-        return m_resistances[i];
+        return quantity<si::resistance>::from_value(m_values[i]);
     }
     quantity<si::capacitance> capacitance(std::size_t i) const {
-        return m_capacitances[i];
+        return quantity<si::capacitance>::from_value(m_values[node_count()+i]);
+    }
+
+    const std::size_t * preds() const {
+        return m_pred.data();
+    }
+    /// Resistances in ohms, indexed by capacitor.
+    const double * resistances() const {
+        return m_values.data();
+    }
+    /// Capacitances in farads, indexed by capacitor.
+    const double * capacitances() const {
+        return m_values.data() + node_count();
     }
 
     std::size_t tap(const std::string & name) const {
         return m_taps.at(name);
     }
 
+    std::size_t tap(entity_system::entity pin) const {
+        auto result = std::lower_bound(m_pin_taps.begin(), m_pin_taps.end(), std::make_pair(pin, std::size_t(0)));
+        if(result == m_pin_taps.end() || !(result->first == pin))
+            throw std::out_of_range("packed_rc_tree::tap");
+        return result->second;
+    }
+
+    bool has_pin_taps() const {
+        return !m_pin_taps.empty();
+    }
 
     void tap(const std::string & name, std::size_t value);
+    void tap(entity_system::entity pin, std::size_t value);
 
 
 };
@@ -85,6 +120,7 @@ private:
 	graph_t::EdgeMap<quantity<si::resistance> > m_resistances;
 	quantity<si::capacitance> m_lumped_capacitance;
     std::vector< graph_t::Node > m_taps;
+    std::vector< entity_system::entity > m_tap_pins;
 
 	std::unordered_map<std::string, lemon::ListGraph::Node> m_name2node;
 public:
@@ -118,6 +154,8 @@ public:
 	}
     /// Set a capacitor as a tap node of the RC Tree.
     void tap_insert(capacitor_id cap);
+    /// Set a capacitor as the tap node of a pin, so the packed tree can be searched by pin.
+    void tap_insert(capacitor_id cap, entity_system::entity pin);
 
     /// Capacitor insertion.
     /**
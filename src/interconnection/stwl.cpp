@@ -22,6 +22,8 @@ under the License.
 #include "hpwl.h"
 #include "flute.h"
 
+#include <cstdlib>
+
 namespace ophidian {
     namespace interconnection {
         double stwl(const std::vector<geometry::point<double> >&points) {
@@ -36,7 +38,7 @@ namespace ophidian {
                 Y.push_back(p.y());
             }
             auto tree = flute(points.size(), X.data(), Y.data(), ACCURACY);
-            delete tree.branch;
+            free(tree.branch);
             return tree.length;
         }
     }
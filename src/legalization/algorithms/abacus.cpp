@@ -20,6 +20,10 @@ under the License.
 
 #include "abacus.h"
 
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
 namespace ophidian {
 namespace legalization {
 namespace abacus {
@@ -36,70 +40,156 @@ void abacus::legalize_placement() {
     }
     std::sort(sorted_cells.begin(), sorted_cells.end(), cell_comparator());
 
+    std::vector<entity_system::entity> abacus_cells;
+    abacus_cells.reserve(sorted_cells.size());
     for (std::size_t sorted_cell_id = 0; sorted_cell_id < sorted_cells.size(); sorted_cell_id++) {
         auto cell = sorted_cells.at(sorted_cell_id).first;
-        point cell_position = m_placement->cell_position(cell);
-        point cell_dimensions = m_placement->cell_dimensions(cell);
-
         auto abacus_cell = m_cells_system.create();
         m_cells.netlist_cell(abacus_cell, cell);
         m_cells.order_id(abacus_cell, sorted_cell_id);
-        m_cells.position(abacus_cell, cell_position);
-        m_cells.width(abacus_cell, cell_dimensions.x());
+        m_cells.position(abacus_cell, m_placement->cell_position(cell));
+        m_cells.width(abacus_cell, m_placement->cell_dimensions(cell).x());
         m_cells.weight(abacus_cell, std::max((int)m_placement->netlist().cell_pins(cell).size(), 1));
+        abacus_cells.push_back(abacus_cell);
+    }
 
-        int best_cost = std::numeric_limits<int>::max();
-        entity_system::entity best_subrow;
-        unsigned subrows_to_search = 3;
-        while (best_cost == std::numeric_limits<int>::max()) {
-            std::vector<entity_system::entity> closest_subrows = m_subrows.find_closest_subrows(cell_position, subrows_to_search);
-            for (auto trial_subrow : closest_subrows) {
-                double subrow_y = m_floorplan->row_origin(m_subrows.row(trial_subrow)).y();
-                point target_position(cell_position.x(), subrow_y);
-                if (target_position.x() < m_subrows.begin(trial_subrow)) {
-                    target_position.x(m_subrows.begin(trial_subrow));
-                }
-                if (target_position.x() + cell_dimensions.x() - 1 > m_subrows.end(trial_subrow)) {
-                    target_position.x(m_subrows.end(trial_subrow) - cell_dimensions.x() + 1);
-                }
-                m_cells.position(abacus_cell, target_position);
-                if (m_abacus_subrows.insert_cell(trial_subrow, abacus_cell, cell_dimensions.x())) {
-                    place_row(trial_subrow);
-                    auto last_cell = m_abacus_subrows.cells(trial_subrow).back();
-                    point last_cell_position = m_cells.position(last_cell);
-                    double cost = std::abs(last_cell_position.x() - cell_position.x()) + std::abs(last_cell_position.y() - cell_position.y());
-                    if (cost < best_cost) {
-                        best_cost = cost;
-                        best_subrow = trial_subrow;
-                    }
-                    m_abacus_subrows.remove_last_cell(trial_subrow, cell_dimensions.x());
-                }
+    if (m_band_count > 1) {
+        legalize_bands(abacus_cells);
+    } else {
+        for (auto abacus_cell : abacus_cells) {
+            entity_system::entity best_subrow;
+            if (!find_subrow(abacus_cell, std::numeric_limits<double>::lowest(), std::numeric_limits<double>::max(), best_subrow)) {
+                throw std::runtime_error("abacus: no subrow has room for a cell");
             }
-            subrows_to_search *= 2;
+            place_cell(best_subrow, abacus_cell);
         }
+    }
 
-        double final_y = m_floorplan->row_origin(m_subrows.row(best_subrow)).y();
-        point final_position(cell_position.x(), final_y);
-        if (final_position.x() < m_subrows.begin(best_subrow)) {
-            final_position.x(m_subrows.begin(best_subrow));
-        }
-        if (final_position.x() + cell_dimensions.x() - 1 > m_subrows.end(best_subrow)) {
-            final_position.x(m_subrows.end(best_subrow) - cell_dimensions.x() + 1);
+    write_positions();
+}
+
+void abacus::legalize_bands(const std::vector<entity_system::entity> &abacus_cells) {
+    std::vector<double> row_ys;
+    for (auto subrow : m_subrows_system) {
+        row_ys.push_back(m_subrows.y(subrow));
+    }
+    std::sort(row_ys.begin(), row_ys.end());
+    row_ys.erase(std::unique(row_ys.begin(), row_ys.end()), row_ys.end());
+    if (row_ys.empty()) {
+        // no band to split, and no subrow for any cell, as in the serial path
+        if (!abacus_cells.empty()) {
+            throw std::runtime_error("abacus: no subrow has room for a cell");
         }
-        m_cells.position(abacus_cell, final_position);
-        if (m_abacus_subrows.insert_cell(best_subrow, abacus_cell, cell_dimensions.x())) {
-            place_row(best_subrow);
+        return;
+    }
+
+    // band i holds the rows [band_rows[i], band_rows[i+1])
+    std::size_t band_count = std::min(m_band_count, row_ys.size());
+    std::vector<std::size_t> band_rows(band_count + 1);
+    for (std::size_t band = 0; band <= band_count; ++band) {
+        band_rows[band] = band * row_ys.size() / band_count;
+    }
+
+    // cells aligned to the first or last row of a band may belong to the
+    // neighbouring band, they are placed by a serial pass
+    std::vector<std::vector<entity_system::entity>> band_cells(band_count);
+    std::vector<entity_system::entity> border_cells;
+    for (auto abacus_cell : abacus_cells) {
+        std::size_t row = std::lower_bound(row_ys.begin(), row_ys.end(), m_cells.position(abacus_cell).y()) - row_ys.begin();
+        row = std::min(row, row_ys.size() - 1);
+        std::size_t band = std::upper_bound(band_rows.begin(), band_rows.end(), row) - band_rows.begin() - 1;
+        bool border = (row == band_rows[band] && band > 0) || (row + 1 == band_rows[band + 1] && band + 1 < band_count);
+        if (border) {
+            border_cells.push_back(abacus_cell);
         } else {
-            assert(false);
+            band_cells[band].push_back(abacus_cell);
         }
     }
 
-    for (auto subrow : m_subrows_system) {
-        auto & subrow_cells = m_abacus_subrows.cells(subrow);
-        for (auto cell : subrow_cells) {
-            m_placement->cell_position(m_cells.netlist_cell(cell), m_cells.position(cell));
+    // border cells go first: every row is still empty, so they are placed in x order
+    std::vector<entity_system::entity> touched_subrows;
+    auto place_anywhere = [this, &touched_subrows](entity_system::entity abacus_cell) {
+        entity_system::entity best_subrow;
+        if (!find_subrow(abacus_cell, std::numeric_limits<double>::lowest(), std::numeric_limits<double>::max(), best_subrow)) {
+            throw std::runtime_error("abacus: no subrow has room for a cell");
+        }
+        place_cell(best_subrow, abacus_cell);
+        touched_subrows.push_back(best_subrow);
+    };
+    for (auto abacus_cell : border_cells) {
+        place_anywhere(abacus_cell);
+    }
+
+    std::vector<std::vector<entity_system::entity>> overflow_cells(band_count);
+#pragma omp parallel for schedule(dynamic)
+    for (std::size_t band = 0; band < band_count; ++band) {
+        double min_y = row_ys[band_rows[band]];
+        double max_y = row_ys[band_rows[band + 1] - 1];
+        for (auto abacus_cell : band_cells[band]) {
+            entity_system::entity best_subrow;
+            if (find_subrow(abacus_cell, min_y, max_y, best_subrow)) {
+                place_cell(best_subrow, abacus_cell);
+            } else {
+                overflow_cells[band].push_back(abacus_cell);
+            }
+        }
+    }
+
+    for (auto & cells : overflow_cells) {
+        for (auto abacus_cell : cells) {
+            place_anywhere(abacus_cell);
         }
     }
+    // rows that got cells out of x order are placed again
+    std::sort(touched_subrows.begin(), touched_subrows.end());
+    touched_subrows.erase(std::unique(touched_subrows.begin(), touched_subrows.end()), touched_subrows.end());
+
+#pragma omp parallel for schedule(dynamic)
+    for (std::size_t i = 0; i < touched_subrows.size(); ++i) {
+        replace_row(touched_subrows[i]);
+    }
+}
+
+bool abacus::find_subrow(entity_system::entity abacus_cell, double min_y, double max_y, entity_system::entity &best_subrow) {
+    point cell_position = m_cells.position(abacus_cell);
+    double cell_width = m_cells.width(abacus_cell);
+    double best_cost = std::numeric_limits<double>::max();
+    unsigned subrows_to_search = 3;
+    while (best_cost == std::numeric_limits<double>::max()) {
+        std::vector<entity_system::entity> closest_subrows = m_subrows.find_closest_subrows(cell_position, subrows_to_search, min_y, max_y);
+        for (auto trial_subrow : closest_subrows) {
+            if (cell_width > m_abacus_subrows.capacity(trial_subrow)) {
+                continue;
+            }
+            point target = target_position(cell_position, cell_width, trial_subrow);
+            double x = trial_position(trial_subrow, target.x(), cell_width, m_cells.weight(abacus_cell));
+            double cost = std::abs(x - cell_position.x()) + std::abs(target.y() - cell_position.y());
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_subrow = trial_subrow;
+            }
+        }
+        if (closest_subrows.size() < subrows_to_search) {
+            break;
+        }
+        subrows_to_search *= 2;
+    }
+    if (best_cost == std::numeric_limits<double>::max()) {
+        return false;
+    }
+    m_cells.position(abacus_cell, target_position(cell_position, cell_width, best_subrow));
+    return true;
+}
+
+abacus::point abacus::target_position(point cell_position, double cell_width, entity_system::entity subrow) {
+    point target(cell_position.x(), m_floorplan->row_origin(m_subrows.row(subrow)).y());
+    if (target.x() < m_subrows.begin(subrow)) {
+        target.x(m_subrows.begin(subrow));
+    }
+    if (target.x() + cell_width - 1 > m_subrows.end(subrow)) {
+        target.x(m_subrows.end(subrow) - cell_width + 1);
+    }
+    return target;
 }
 
 void abacus::align_cells()
@@ -121,67 +211,96 @@ void abacus::align_position(point &position)
     position.y(row_origin.y());
 }
 
-void abacus::place_row(entity_system::entity subrow) {
-    std::list<cluster> clusters;
-    auto cells = m_abacus_subrows.cells(subrow);
-    for (auto cell : cells) {
-        double cell_begin = m_cells.position(cell).x();
-        double cell_width = m_cells.width(cell);
-        auto cluster_it = clusters.end();
-        if (!clusters.empty()) {
-            cluster_it--;
-        }
-        if (clusters.empty() || cluster_it->m_begin + cluster_it->m_size <= cell_begin) {
-            cluster new_cluster(cell_begin);
-            new_cluster.insert_cell(m_cells.order_id(cell), cell_begin, cell_width, m_cells.weight(cell));
-            clusters.insert(clusters.end(), new_cluster);
-        } else {
-            cluster_it->insert_cell(m_cells.order_id(cell), cell_begin, cell_width, m_cells.weight(cell));
-            collapse(clusters, cluster_it, m_subrows.begin(subrow), m_subrows.end(subrow), m_floorplan->row_origin(m_subrows.row(subrow)).y());
-        }
+double abacus::optimal_begin(const cluster &cluster, entity_system::entity subrow) {
+    double optimal_x = cluster.m_displacement / cluster.m_weight;
+    optimal_x = std::min(std::max(optimal_x, m_subrows.begin(subrow)), m_subrows.end(subrow) - cluster.m_size + 1);
+    double site_width = m_floorplan->site_dimensions(m_floorplan->row_site(m_subrows.row(subrow))).x();
+    return std::floor(optimal_x / site_width) * site_width;
+}
+
+double abacus::trial_position(entity_system::entity subrow, double x, double width, double weight) {
+    const std::vector<cluster> & clusters = m_abacus_subrows.clusters(subrow);
+    if (clusters.empty() || clusters.back().m_begin + clusters.back().m_size <= x) {
+        return x;
     }
 
-    auto & subrow_cells = m_abacus_subrows.cells(subrow);
-    double subrow_y = m_floorplan->row_origin(m_subrows.row(subrow)).y();
-    auto cell_it = subrow_cells.begin();
-    for (auto & cluster : clusters) {
-        double x = cluster.m_begin;
-        unsigned i = m_cells.order_id(*cell_it);
-        while (i <= cluster.m_last_order_id) {
-            point cell_position(x, subrow_y);
-            m_cells.position(*cell_it, cell_position);
-            x += m_cells.width(*cell_it);
-            cell_it++;
-            if (cell_it != subrow_cells.end()) {
-                i = m_cells.order_id(*cell_it);
-            } else {
-                i = std::numeric_limits<unsigned>::max();
-            }
+    // collapse a copy of the last cluster, merging copies of its predecessors while they overlap
+    cluster trial = clusters.back();
+    trial.insert_cell(0, x, width, weight);
+    std::size_t previous = clusters.size() - 1;
+    trial.m_begin = optimal_begin(trial, subrow);
+    while (previous > 0 && clusters[previous - 1].m_begin + clusters[previous - 1].m_size >= trial.m_begin) {
+        cluster merged = clusters[previous - 1];
+        merged.insert_cluster(trial);
+        trial = merged;
+        trial.m_begin = optimal_begin(trial, subrow);
+        --previous;
+    }
+    return trial.m_begin + trial.m_size - width;
+}
+
+void abacus::place_cell(entity_system::entity subrow, entity_system::entity cell) {
+    double cell_begin = m_cells.position(cell).x();
+    double cell_width = m_cells.width(cell);
+    if (!m_abacus_subrows.insert_cell(subrow, cell, cell_width)) {
+        assert(false);
+    }
+
+    std::vector<cluster> & clusters = m_abacus_subrows.clusters(subrow);
+    if (clusters.empty() || clusters.back().m_begin + clusters.back().m_size <= cell_begin) {
+        cluster new_cluster(cell_begin, m_abacus_subrows.cells(subrow).size() - 1);
+        new_cluster.insert_cell(m_cells.order_id(cell), cell_begin, cell_width, m_cells.weight(cell));
+        clusters.push_back(new_cluster);
+    } else {
+        clusters.back().insert_cell(m_cells.order_id(cell), cell_begin, cell_width, m_cells.weight(cell));
+        collapse(subrow);
+    }
+}
+
+void abacus::collapse(entity_system::entity subrow) {
+    std::vector<cluster> & clusters = m_abacus_subrows.clusters(subrow);
+    clusters.back().m_begin = optimal_begin(clusters.back(), subrow);
+    while (clusters.size() > 1) {
+        cluster & previous_cluster = clusters[clusters.size() - 2];
+        if (previous_cluster.m_begin + previous_cluster.m_size < clusters.back().m_begin) {
+            break;
         }
+        previous_cluster.insert_cluster(clusters.back());
+        clusters.pop_back();
+        clusters.back().m_begin = optimal_begin(clusters.back(), subrow);
     }
 }
 
-void abacus::collapse(std::list<cluster> &clusters, std::list<cluster>::iterator cluster_it, double x_min, double x_max, double y) {
-    bool collapsed = false;
-    while (!collapsed) {
-        double optimal_x = cluster_it->m_displacement / cluster_it->m_weight;
-        optimal_x = std::min(std::max(optimal_x, x_min), x_max - cluster_it->m_size + 1);
-        point optimal_position(optimal_x, y);
-        this->align_position(optimal_position);
+void abacus::replace_row(entity_system::entity subrow) {
+    std::vector<entity_system::entity> cells = m_abacus_subrows.cells(subrow);
+    std::sort(cells.begin(), cells.end(), [this](entity_system::entity a, entity_system::entity b) {
+        double a_x = m_cells.position(a).x();
+        double b_x = m_cells.position(b).x();
+        return a_x < b_x || (a_x == b_x && m_cells.order_id(a) < m_cells.order_id(b));
+    });
+    for (auto cell : cells) {
+        m_abacus_subrows.remove_last_cell(subrow, m_cells.width(cell));
+    }
+    m_abacus_subrows.clusters(subrow).clear();
+    for (auto cell : cells) {
+        place_cell(subrow, cell);
+    }
+}
 
-        cluster_it->m_begin = optimal_position.x();
-        if (cluster_it != clusters.begin()) {
-            auto previous_cluster = cluster_it;
-            previous_cluster--;
-            if (previous_cluster->m_begin + previous_cluster->m_size >= cluster_it->m_begin) {
-                previous_cluster->insert_cluster(*cluster_it);
-                clusters.erase(cluster_it);
-                cluster_it = previous_cluster;
-            } else {
-                collapsed = true;
+void abacus::write_positions() {
+    for (auto subrow : m_subrows_system) {
+        auto & subrow_cells = m_abacus_subrows.cells(subrow);
+        auto & clusters = m_abacus_subrows.clusters(subrow);
+        double subrow_y = m_floorplan->row_origin(m_subrows.row(subrow)).y();
+        for (std::size_t cluster_id = 0; cluster_id < clusters.size(); ++cluster_id) {
+            std::size_t cells_end = cluster_id + 1 < clusters.size() ? clusters[cluster_id + 1].m_first_cell : subrow_cells.size();
+            double x = clusters[cluster_id].m_begin;
+            for (std::size_t cell_id = clusters[cluster_id].m_first_cell; cell_id < cells_end; ++cell_id) {
+                auto cell = subrow_cells[cell_id];
+                m_cells.position(cell, point(x, subrow_y));
+                m_placement->cell_position(m_cells.netlist_cell(cell), m_cells.position(cell));
+                x += m_cells.width(cell);
             }
-        } else {
-            collapsed = true;
         }
     }
 }
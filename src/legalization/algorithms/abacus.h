@@ -35,48 +35,36 @@ public:
     }
 };
 
-struct cluster {
-    double m_begin;
-    unsigned m_last_order_id;
-    double m_size;
-    double m_displacement;
-    double m_weight;
-
-    cluster(double begin)
-        : m_begin(begin), m_last_order_id(0), m_size(0), m_displacement(0), m_weight(0) {
-
-    }
-
-    void insert_cell(unsigned order_id, double x, double width, double weight) {
-        m_last_order_id = order_id;
-        m_displacement += weight*(x - m_size);
-        m_size += width;
-        m_weight += weight;
-    }
-
-    void insert_cluster(cluster & cluster) {
-        m_last_order_id = cluster.m_last_order_id;
-        m_displacement += cluster.m_displacement - (cluster.m_weight - m_size);
-        m_size += cluster.m_size;
-        m_weight += cluster.m_weight;
-    }
-};
-
 class abacus : public legalization {
     entity_system::entity_system m_cells_system;
     cells m_cells;
 
     subrows m_abacus_subrows;
 
+    std::size_t m_band_count;
+
     void align_cells();
     void align_position(point & position);
 
-    void place_row(entity_system::entity subrow);
-
-    void collapse(std::list<cluster> & clusters, std::list<cluster>::iterator cluster_it, double x_min, double x_max, double y);
+    void legalize_bands(const std::vector<entity_system::entity> & abacus_cells);
+    bool find_subrow(entity_system::entity abacus_cell, double min_y, double max_y, entity_system::entity & best_subrow);
+    point target_position(point cell_position, double cell_width, entity_system::entity subrow);
+    double optimal_begin(const cluster & cluster, entity_system::entity subrow);
+    // x of a cell appended to the subrow, computed without changing its clusters
+    double trial_position(entity_system::entity subrow, double x, double width, double weight);
+    void place_cell(entity_system::entity subrow, entity_system::entity cell);
+    void collapse(entity_system::entity subrow);
+    void replace_row(entity_system::entity subrow);
+    void write_positions();
 public:
-    abacus(floorplan::floorplan *floorplan, placement::placement *placement)
-        : legalization(floorplan, placement), m_cells(m_cells_system), m_abacus_subrows(m_subrows_system) {
+    /// Creates the legalizer; with band_count > 1 the rows are split in that many horizontal bands legalized in parallel.
+    /**
+     * Cells on the first or last row of a band are placed before the bands,
+     * and cells that do not fit in their band after them, in a serial pass.
+     * The result depends on band_count only, not on the number of threads.
+     */
+    abacus(floorplan::floorplan *floorplan, placement::placement *placement, std::size_t band_count = 1)
+        : legalization(floorplan, placement), m_cells(m_cells_system), m_abacus_subrows(m_subrows_system), m_band_count(band_count) {
         create_subrows();
     }
 
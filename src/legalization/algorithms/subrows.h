@@ -29,20 +29,60 @@ under the License.
 namespace ophidian {
 namespace legalization {
 namespace abacus {
+struct cluster {
+    double m_begin;
+    std::size_t m_first_cell;
+    unsigned m_last_order_id;
+    double m_size;
+    double m_displacement;
+    double m_weight;
+
+    cluster(double begin, std::size_t first_cell)
+        : m_begin(begin), m_first_cell(first_cell), m_last_order_id(0), m_size(0), m_displacement(0), m_weight(0) {
+
+    }
+
+    void insert_cell(unsigned order_id, double x, double width, double weight) {
+        m_last_order_id = order_id;
+        m_displacement += weight*(x - m_size);
+        m_size += width;
+        m_weight += weight;
+    }
+
+    void insert_cluster(const cluster & cluster) {
+        m_last_order_id = cluster.m_last_order_id;
+        m_displacement += cluster.m_displacement - cluster.m_weight * m_size;
+        m_size += cluster.m_size;
+        m_weight += cluster.m_weight;
+    }
+};
+
 class subrows {
     entity_system::entity_system & m_system;
 
     entity_system::vector_property<std::vector<entity_system::entity>> m_cells;
+    entity_system::vector_property<std::vector<cluster>> m_clusters;
     entity_system::vector_property<double> m_capacity;
 public:
     subrows(entity_system::entity_system &m_system) : m_system(m_system) {
         m_system.register_property(&m_cells);
+        m_system.register_property(&m_clusters);
         m_system.register_property(&m_capacity);
     }
 
     const std::vector<entity_system::entity> & cells(entity_system::entity row) {
         return m_cells[m_system.lookup(row)];
     }
+    // clusters of the row, left to right; each one covers the cells from its
+    // m_first_cell up to the m_first_cell of the next one
+    std::vector<cluster> & clusters(entity_system::entity row) {
+        return m_clusters[m_system.lookup(row)];
+    }
+
+    const std::vector<cluster> & clusters(entity_system::entity row) const {
+        return m_clusters[m_system.lookup(row)];
+    }
+
     bool insert_cell(entity_system::entity row, entity_system::entity cell, double cell_width);
     void remove_last_cell(entity_system::entity row, double cell_width);
 
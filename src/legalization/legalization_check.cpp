@@ -19,67 +19,175 @@ under the License.
  */
 
 #include "legalization_check.h"
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace ophidian {
 namespace legalization {
 
+namespace {
+
+// merges per thread results and sorts them like the cell system, so reports do not depend on the thread count
+void merge_sorted(std::vector<std::vector<std::size_t> > & per_thread, const std::vector<entity_system::entity> & cells, std::vector<entity_system::entity> & result) {
+    std::vector<std::size_t> indices;
+    for (auto & thread_indices : per_thread) {
+        indices.insert(indices.end(), thread_indices.begin(), thread_indices.end());
+    }
+    std::sort(indices.begin(), indices.end());
+    result.reserve(indices.size());
+    for (auto index : indices) {
+        result.push_back(cells[index]);
+    }
+}
+
+int thread_count() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+int thread_id() {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+struct indexed_overlap {
+    double area;
+    std::size_t first;
+    std::size_t second;
+};
+
+// larger overlaps first, ties broken by rectangle indices
+bool worse(const indexed_overlap & a, const indexed_overlap & b) {
+    if (a.area != b.area) {
+        return a.area > b.area;
+    }
+    return a.first != b.first ? a.first < b.first : a.second < b.second;
+}
+
+}
+
 bool legalization_check::check_legality() {
-    bool legality = check_boundaries() && check_alignment() && check_cell_overlaps();
-    return legality;
+    return report(0).legal();
 }
 
-bool legalization_check::check_cell_overlaps() {
-    rtree cell_boxes_rtree;
-    for (auto cell : m_placement->netlist().cell_system()) {
-        auto cell_geometry = m_placement->cell_geometry(cell);
-        for (auto cell_polygon : cell_geometry) {
-            box cell_box;
-            boost::geometry::envelope(cell_polygon, cell_box);
-            cell_box.max_corner().x(cell_box.max_corner().x()-1);
-            cell_box.max_corner().y(cell_box.max_corner().y()-1);
-
-            std::vector<rtree_node> intersecting_nodes;
-            cell_boxes_rtree.query(boost::geometry::index::intersects(cell_box), std::back_inserter(intersecting_nodes));
-            if (intersecting_nodes.empty()) {
-                cell_boxes_rtree.insert(std::make_pair(cell_box, cell));
-            } else {
-                return false;
+legality_report legalization_check::report(std::size_t worst_overlap_count) {
+    std::vector<entity_system::entity> cells(m_placement->netlist().cell_system().begin(), m_placement->netlist().cell_system().end());
+    legality_report result;
+    check_boundaries(cells, result);
+    check_alignment(cells, result);
+    check_cell_overlaps(cells, worst_overlap_count, result);
+    return result;
+}
+
+void legalization_check::check_cell_overlaps(const std::vector<entity_system::entity> & cells, std::size_t worst_overlap_count, legality_report & report) {
+    using indexed_node = std::pair<box, std::size_t>;
+    std::vector<indexed_node> nodes;
+    std::vector<std::size_t> owners;
+    nodes.reserve(cells.size());
+    owners.reserve(cells.size());
+    for (std::size_t cell = 0; cell < cells.size(); ++cell) {
+        auto position = m_placement->cell_position(cells[cell]);
+        for (auto & rectangle : m_placement->cell_rectangles(cells[cell])) {
+            box cell_box(point(position.x() + rectangle.min_corner().x(), position.y() + rectangle.min_corner().y()),
+                         point(position.x() + rectangle.max_corner().x(), position.y() + rectangle.max_corner().y()));
+            nodes.push_back(std::make_pair(cell_box, nodes.size()));
+            owners.push_back(cell);
+        }
+    }
+    // the packing constructor bulk loads the tree
+    const boost::geometry::index::rtree<indexed_node, boost::geometry::index::rstar<16> > cell_boxes_rtree(nodes.begin(), nodes.end());
+
+    std::vector<std::size_t> overlap_counts(thread_count(), 0);
+    std::vector<std::vector<indexed_overlap> > worst(thread_count());
+#pragma omp parallel
+    {
+        std::vector<indexed_node> intersecting_nodes;
+        std::size_t & overlaps = overlap_counts[thread_id()];
+        auto & thread_worst = worst[thread_id()];
+#pragma omp for schedule(dynamic, 1024)
+        for (std::size_t node = 0; node < nodes.size(); ++node) {
+            // shrinking the query by one unit ignores rectangles that only touch
+            const box & cell_box = nodes[node].first;
+            box query(cell_box.min_corner(), point(cell_box.max_corner().x() - 1, cell_box.max_corner().y() - 1));
+            intersecting_nodes.clear();
+            cell_boxes_rtree.query(boost::geometry::index::intersects(query), std::back_inserter(intersecting_nodes));
+            for (auto & other : intersecting_nodes) {
+                // each pair is counted once, from its first rectangle
+                if (other.second <= node || owners[other.second] == owners[node]) {
+                    continue;
+                }
+                const box & other_box = other.first;
+                double width = std::min(cell_box.max_corner().x(), other_box.max_corner().x()) - std::max(cell_box.min_corner().x(), other_box.min_corner().x());
+                double height = std::min(cell_box.max_corner().y(), other_box.max_corner().y()) - std::max(cell_box.min_corner().y(), other_box.min_corner().y());
+                if (width < 1 || height < 1) {
+                    continue;
+                }
+                ++overlaps;
+                if (worst_overlap_count == 0) {
+                    continue;
+                }
+                indexed_overlap overlap{width * height, node, other.second};
+                if (thread_worst.size() < worst_overlap_count) {
+                    thread_worst.push_back(overlap);
+                    std::push_heap(thread_worst.begin(), thread_worst.end(), worse);
+                } else if (worse(overlap, thread_worst.front())) {
+                    std::pop_heap(thread_worst.begin(), thread_worst.end(), worse);
+                    thread_worst.back() = overlap;
+                    std::push_heap(thread_worst.begin(), thread_worst.end(), worse);
+                }
             }
         }
     }
-    return true;
+
+    std::vector<indexed_overlap> merged;
+    for (std::size_t thread = 0; thread < worst.size(); ++thread) {
+        report.overlaps += overlap_counts[thread];
+        merged.insert(merged.end(), worst[thread].begin(), worst[thread].end());
+    }
+    std::sort(merged.begin(), merged.end(), worse);
+    merged.resize(std::min(merged.size(), worst_overlap_count));
+    for (auto & overlap : merged) {
+        report.worst_overlaps.push_back({cells[owners[overlap.first]], cells[owners[overlap.second]], overlap.area});
+    }
 }
 
-bool legalization_check::check_alignment() {
-    for (auto cell_position : m_placement->cell_properties().positions()) {
+void legalization_check::check_alignment(const std::vector<entity_system::entity> & cells, legality_report & report) {
+    std::vector<std::vector<std::size_t> > misaligned(thread_count());
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (std::size_t cell = 0; cell < cells.size(); ++cell) {
+        auto cell_position = m_placement->cell_position(cells[cell]);
         try {
             auto row = m_floorplan->find_row(cell_position);
             point row_origin = m_floorplan->row_origin(row);
             double site_width = m_floorplan->site_dimensions(m_floorplan->row_site(row)).x();
             if ((cell_position.y() != row_origin.y()) || ((int)cell_position.x() % (int)site_width != 0)) {
-                return false;
+                misaligned[thread_id()].push_back(cell);
             }
         } catch (floorplan::row_not_found) {
-            return false;
+            misaligned[thread_id()].push_back(cell);
         }
     }
-    return true;
+    merge_sorted(misaligned, cells, report.misaligned);
 }
 
-bool legalization_check::check_boundaries() {
+void legalization_check::check_boundaries(const std::vector<entity_system::entity> & cells, legality_report & report) {
     box chip_area(m_floorplan->chip_origin(), m_floorplan->chip_boundaries());
-    for (auto cell_geometry : m_placement->cell_properties().geometries()) {
-        box cell_boundaries;
-        boost::geometry::envelope(cell_geometry, cell_boundaries);
-        for (auto cell_polygon : cell_geometry) {
-            for (auto cell_point : cell_polygon.outer()) {
-                if (!boost::geometry::intersects(cell_point, chip_area)) {
-                    return false;
-                }
-            }
+    std::vector<std::vector<std::size_t> > out_of_boundaries(thread_count());
+#pragma omp parallel for schedule(static)
+    for (std::size_t cell = 0; cell < cells.size(); ++cell) {
+        if (!m_placement->cell_rectangles(cells[cell]).empty() && !boost::geometry::covered_by(m_placement->cell_box(cells[cell]), chip_area)) {
+            out_of_boundaries[thread_id()].push_back(cell);
         }
     }
-    return true;
+    merge_sorted(out_of_boundaries, cells, report.out_of_boundaries);
 }
 }
 }
@@ -33,13 +33,41 @@ using box = geometry::box<point>;
 using rtree_node = std::pair<box, entity_system::entity>;
 using rtree = boost::geometry::index::rtree<rtree_node, boost::geometry::index::rstar<16>>;
 
+/// Two cells whose rectangles overlap.
+struct cell_overlap {
+    entity_system::entity first;
+    entity_system::entity second;
+    double area;
+};
+
+/// Violations found by legalization_check::report().
+struct legality_report {
+    /// Cells that are not entirely inside the chip.
+    std::vector<entity_system::entity> out_of_boundaries;
+    /// Cells that are not on a row or not on a site.
+    std::vector<entity_system::entity> misaligned;
+    /// Number of overlapping pairs of cell rectangles.
+    std::size_t overlaps = 0;
+    /// Largest overlaps, largest first.
+    std::vector<cell_overlap> worst_overlaps;
+
+    bool legal() const {
+        return out_of_boundaries.empty() && misaligned.empty() && overlaps == 0;
+    }
+};
+
+/// Checks that cells are inside the chip, aligned to sites and rows, and do not overlap.
+/**
+ * Every check visits all cells in parallel. Overlaps are found by querying an R-tree bulk loaded with
+ * all cell rectangles; rectangles that only touch do not overlap.
+ */
 class legalization_check {
     floorplan::floorplan * m_floorplan;
     placement::placement * m_placement;
 
-    bool check_alignment();
-    bool check_boundaries();
-    bool check_cell_overlaps();
+    void check_alignment(const std::vector<entity_system::entity> & cells, legality_report & report);
+    void check_boundaries(const std::vector<entity_system::entity> & cells, legality_report & report);
+    void check_cell_overlaps(const std::vector<entity_system::entity> & cells, std::size_t worst_overlap_count, legality_report & report);
 
 public:
 
@@ -47,6 +75,9 @@ public:
                                                                                         m_floorplan), m_placement(m_placement) { }
 
     bool check_legality();
+
+    /// Finds every violation, keeping the worst_overlap_count largest overlaps.
+    legality_report report(std::size_t worst_overlap_count = 10);
 };
 }
 }
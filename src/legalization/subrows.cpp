@@ -31,7 +31,7 @@ void subrows::end(entity_system::entity subrow, double end) {
     m_end[m_system.lookup(subrow)] = end;
 }
 
-double subrows::y(entity_system::entity subrow, double y)
+void subrows::y(entity_system::entity subrow, double y)
 {
     m_y[m_system.lookup(subrow)] = y;
 }
@@ -114,5 +114,19 @@ std::vector<entity_system::entity> subrows::find_closest_subrows(point coordinat
     }
     return subrows;
 }
+
+std::vector<entity_system::entity> subrows::find_closest_subrows(point coordinate, unsigned number_of_rows, double min_y, double max_y) const {
+    std::vector<rtree_node> closest_nodes;
+    auto in_range = [min_y, max_y](const rtree_node & node) {
+        return node.first.min_corner().y() >= min_y && node.first.min_corner().y() <= max_y;
+    };
+    subrows_rtree.query(boost::geometry::index::nearest(coordinate, number_of_rows) && boost::geometry::index::satisfies(in_range), std::back_inserter(closest_nodes));
+    std::vector<entity_system::entity> subrows;
+    subrows.reserve(closest_nodes.size());
+    for (auto node : closest_nodes) {
+        subrows.push_back(node.second);
+    }
+    return subrows;
+}
 }
 }
@@ -74,7 +74,7 @@ public:
         return m_y[m_system.lookup(subrow)];
     }
 
-    double y(entity_system::entity subrow, double y);
+    void y(entity_system::entity subrow, double y);
 
     entity_system::entity row(entity_system::entity subrow) const {
         return m_row[m_system.lookup(subrow)];
@@ -85,6 +85,9 @@ public:
 
     std::vector<entity_system::entity> find_closest_subrows(point coordinate, unsigned number_of_rows) const;
 
+    // only subrows whose y is in [min_y, max_y] are considered
+    std::vector<entity_system::entity> find_closest_subrows(point coordinate, unsigned number_of_rows, double min_y, double max_y) const;
+
 };
 
 class subrow_not_found : public std::exception {
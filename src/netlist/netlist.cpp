@@ -28,16 +28,19 @@ namespace netlist {
 void netlist::pin_preallocate(std::size_t qnt)
 {
     m_pins_system.preallocate(qnt);
+    m_name2pin.reserve(qnt);
 }
 
 void netlist::net_preallocate(std::size_t qnt)
 {
-    m_pins_system.preallocate(qnt);
+    m_nets_system.preallocate(qnt);
+    m_name2net.reserve(qnt);
 }
 
 void netlist::cell_preallocate(std::size_t qnt)
 {
-    m_pins_system.preallocate(qnt);
+    m_cells_system.preallocate(qnt);
+    m_name2cell.reserve(qnt);
 }
 
 netlist::netlist(standard_cell::standard_cells * std_cells) :
@@ -29,17 +29,36 @@ void verilog2netlist(const parsing::verilog &verilog, netlist &netlist)
     netlist.pin_preallocate(verilog.pin_count());
     netlist.net_preallocate(verilog.net_count());
     netlist.module_name(verilog.design());
-    for(auto input : verilog.inputs())
-        netlist.connect(netlist.net_insert(input), netlist.PI_insert(input));
-    for(auto output : verilog.outputs())
-        netlist.connect(netlist.net_insert(output), netlist.PO_insert(output));
-    for(auto wire : verilog.wires())
-        netlist.net_insert(wire);
-    for(auto module : verilog.modules())
+
+    // names are looked up in the netlist only once, nets are then found by name_id
+    const std::vector<std::string> & names = verilog.names();
+    std::vector<std::size_t> net_pin_count(names.size(), 0);
+    for(auto input : verilog.input_ids())
+        ++net_pin_count[input];
+    for(auto output : verilog.output_ids())
+        ++net_pin_count[output];
+    for(auto & pin : verilog.instance_pins())
+        ++net_pin_count[pin.second];
+
+    std::vector<entity_system::entity> nets(names.size());
+    auto net = [&netlist, &names, &net_pin_count, &nets](parsing::verilog::name_id id) -> entity_system::entity {
+        if(nets[id] == entity_system::invalid_entity)
+            nets[id] = netlist.net_insert(names[id], net_pin_count[id]);
+        return nets[id];
+    };
+
+    for(auto input : verilog.input_ids())
+        netlist.connect(net(input), netlist.PI_insert(names[input]));
+    for(auto output : verilog.output_ids())
+        netlist.connect(net(output), netlist.PO_insert(names[output]));
+    for(auto wire : verilog.net_ids())
+        net(wire);
+    const auto & pins = verilog.instance_pins();
+    for(auto & cell : verilog.instances())
     {
-        auto cell_entity = netlist.cell_insert(module.name, module.type);
-        for(auto pinnet_pair : module.pinnet_pairs)
-            netlist.connect(netlist.net_insert(pinnet_pair.second), netlist.pin_insert(cell_entity, pinnet_pair.first));
+        auto cell_entity = netlist.cell_insert(names[cell.name], names[cell.type]);
+        for(std::size_t i = cell.pins_begin; i < cell.pins_end; ++i)
+            netlist.connect(net(pins[i].second), netlist.pin_insert(cell_entity, names[pins[i].first]));
     }
 }
 
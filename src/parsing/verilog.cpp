@@ -21,12 +21,19 @@ under the License.
 #include "verilog.h"
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/utility/string_ref.hpp>
 
 
 #include <iostream>
-#include <fstream>
-#include <unordered_set>
+#include <stdexcept>
+#include <limits>
 #include <algorithm>
+#include <cctype>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
 namespace ophidian {
@@ -44,275 +51,269 @@ bool is_special_char(char c) {
     return false;
 }
 
-std::vector<std::string> verilog::tokenize(std::string line) {
-    std::vector<std::string> tokens;
-    //    tokens.reserve(num_spaces+1);
-    std::string last_token;
-    for (auto c : line) {
-        if (isspace(c) || is_special_char(c)) {
-            if (!last_token.empty()) {
-                tokens.push_back(last_token);
-                last_token.clear();
+namespace {
+
+using token = boost::string_ref;
+
+class mapped_file {
+    int m_file;
+    const char * m_data;
+    std::size_t m_size;
+public:
+    explicit mapped_file(const std::string & filename) :
+        m_file(open(filename.c_str(), O_RDONLY)),
+        m_data(nullptr),
+        m_size(0)
+    {
+        if(m_file < 0)
+            throw std::runtime_error("verilog: cannot open " + filename);
+        struct stat status;
+        if(fstat(m_file, &status) != 0)
+        {
+            close(m_file);
+            throw std::runtime_error("verilog: cannot stat " + filename);
+        }
+        m_size = static_cast<std::size_t>(status.st_size);
+        if(m_size > 0)
+        {
+            void * data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+            if(data == MAP_FAILED)
+            {
+                close(m_file);
+                throw std::runtime_error("verilog: cannot map " + filename);
             }
-        } else
-            last_token.push_back(c);
+            m_data = static_cast<const char*>(data);
+        }
     }
-    if (!last_token.empty())
-        tokens.push_back(last_token);
-    return tokens;
-}
+    ~mapped_file() {
+        if(m_data)
+            munmap(const_cast<char*>(m_data), m_size);
+        close(m_file);
+    }
+    mapped_file(const mapped_file &) = delete;
+    mapped_file & operator=(const mapped_file &) = delete;
 
-bool verilog::read_line_as_tokens(std::istream & in, std::vector<std::string> &tokens)
-{
-    tokens.clear();
-    std::string line;
-    std::getline(in, line);
-    tokens.reserve(100);
-    std::string token;
-    token.reserve(100);
-    while (in && tokens.empty())
+    const char * data() const {
+        return m_data;
+    }
+    std::size_t size() const {
+        return m_size;
+    }
+};
+
+// Splits the buffer into tokens separated by white space and special
+// characters, skipping comments. ';' is returned as a token of its own since
+// it ends statements.
+class token_stream {
+    const char * m_it;
+    const char * const m_end;
+    bool m_separator[256];
+
+    bool is_separator(char c) const {
+        return m_separator[static_cast<unsigned char>(c)];
+    }
+public:
+    token_stream(const char * begin, const char * end) :
+        m_it(begin),
+        m_end(end)
     {
-        token.clear();
-        for (unsigned i = 0; i < line.size(); ++i)
+        for(int c = 0; c < 256; ++c)
+            m_separator[c] = std::isspace(c) || is_special_char(static_cast<char>(c));
+    }
+
+    bool next(token & result) {
+        while(m_it != m_end)
         {
-            char currChar = line[i];
-            if (isspace(currChar) || is_special_char(currChar))
+            if(*m_it == '/' && m_it+1 != m_end && m_it[1] == '/')
+                m_it = std::find(m_it, m_end, '\n');
+            else if(*m_it == '/' && m_it+1 != m_end && m_it[1] == '*')
             {
-                if (!token.empty())
-                {
-                    // Add the current token to the list of tokens
-                    tokens.push_back(token);
-                    token.clear();
-                }
-                // else if the token is empty, simply skip the whitespace or special char
+                static const char comment_end[] = "*/";
+                m_it = std::search(m_it+2, m_end, comment_end, comment_end+2);
+                m_it = m_it == m_end ? m_end : m_it+2;
             }
+            else if(*m_it == ';')
+            {
+                result = token(m_it++, 1);
+                return true;
+            }
+            else if(is_separator(*m_it))
+                ++m_it;
             else
             {
-                // Add the char to the current token
-                token.push_back(currChar);
+                const char * begin = m_it;
+                while(m_it != m_end && !is_separator(*m_it))
+                    ++m_it;
+                result = token(begin, m_it - begin);
+                return true;
             }
         }
-
-        if (!token.empty())
-            tokens.push_back(token);
-
-        if (tokens.empty())
-            // Previous line read was empty. Read the next one.
-            std::getline(in, line);
+        return false;
     }
+};
 
-    return !tokens.empty();
-}
+// Interns names with open addressing over views of the mapped file; each
+// slot keeps the name_id and the low bits of its hash.
+class name_table {
+    static const verilog::name_id empty;
 
-bool verilog::read_module(std::istream &in, std::string &token)
-{
-    std::vector<std::string> tokens;
-    bool valid = read_line_as_tokens(in, tokens);
+    std::vector<std::string> & m_names;
+    std::vector<token> m_tokens;
+    std::vector< std::pair<verilog::name_id, std::uint32_t> > m_slots;
+    std::size_t m_mask;
 
-    while (valid)
-    {
-        if (tokens.size() == 2 && tokens[0] == "module")
+    static std::size_t hash(token name) {
+        std::size_t hash = 14695981039346656037ULL;
+        for(char c : name)
         {
-            token = tokens[1];
-            break;
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
         }
-        valid = read_line_as_tokens(in, tokens);
-    }
-
-    // Read and skip the port names in the module definition
-    // until we encounter the tokens {"Start", "PIs"}
-    while (valid && !(tokens.size() == 2 && tokens[0] == "Start" && tokens[1] == "PIs"))
-    {
-        valid = read_line_as_tokens(in, tokens);
-        assert(valid);
+        return hash;
     }
 
-    return valid;
-}
-
-bool verilog::read_primary_input(std::istream &in, std::string &token)
-{
-    token = "";
-
-    std::vector<std::string> tokens;
-    bool valid = read_line_as_tokens(in, tokens);
-
-    assert(valid);
-    assert(tokens.size() == 2);
-
-    if (valid && tokens[0] == "input")
-    {
-        token = tokens[1];
-    }
-    else
-    {
-        assert (tokens[0] == "Start" && tokens[1] == "POs");
-        return false;
+    void place(verilog::name_id id, std::size_t name_hash) {
+        std::size_t slot = name_hash & m_mask;
+        while(m_slots[slot].first != empty)
+            slot = (slot + 1) & m_mask;
+        m_slots[slot] = std::make_pair(id, static_cast<std::uint32_t>(name_hash));
     }
 
-    return valid;
-}
-
-bool verilog::read_primary_output(std::istream &in, std::string &token)
-{
-    token = "";
-
-    std::vector<std::string> tokens;
-    bool valid = read_line_as_tokens(in, tokens);
-
-    assert(valid);
-    assert(tokens.size() == 2);
-
-    if (valid && tokens[0] == "output")
-    {
-        token = tokens[1];
-    }
-    else
-    {
-        assert (tokens[0] == "Start" && tokens[1] == "wires");
-        return false;
+    void grow(std::size_t slot_count) {
+        m_slots.assign(slot_count, std::make_pair(empty, 0u));
+        m_mask = slot_count - 1;
+        for(verilog::name_id id = 0; id < m_tokens.size(); ++id)
+            place(id, hash(m_tokens[id]));
     }
 
-    return valid;
-}
-
-bool verilog::read_cell_inst(std::istream &in, std::string &cell_type, std::string &cell_inst, std::vector<std::pair<std::string, std::string> > &pin_net_pairs)
-{
-    cell_type.clear();
-    cell_inst.clear();
-    pin_net_pairs.clear();
-    std::vector<std::string> tokens;
-    bool valid = read_line_as_tokens(in, tokens);
-    assert(valid);
-
-    if(tokens.size() == 1)
+public:
+    name_table(std::vector<std::string> & names, std::size_t expected) :
+        m_names(names),
+        m_mask(0)
     {
-        assert(tokens.front() == "endmodule");
-        return false;
+        std::size_t slot_count = 1024;
+        while(slot_count < 2*expected)
+            slot_count *= 2;
+        grow(slot_count);
+        m_tokens.reserve(expected);
+        m_names.reserve(expected);
     }
 
-    assert(tokens.size() >= 4);
-
-    cell_type = tokens.at(0);
-    cell_inst = tokens.at(1);
-
-    pin_net_pairs.reserve(tokens.size());
-    for(unsigned i = 2; i < tokens.size() - 1; i += 2)
-    {
-        assert(tokens.at(i).at(0) == '.');
-        std::string pin_name = tokens.at(i).substr(1);
-        pin_net_pairs.push_back(std::make_pair(pin_name, tokens.at(i+1)));
+    verilog::name_id operator()(token name) {
+        const std::size_t name_hash = hash(name);
+        std::size_t slot = name_hash & m_mask;
+        while(m_slots[slot].first != empty)
+        {
+            if(m_slots[slot].second == static_cast<std::uint32_t>(name_hash) && m_tokens[m_slots[slot].first] == name)
+                return m_slots[slot].first;
+            slot = (slot + 1) & m_mask;
+        }
+        const verilog::name_id id = static_cast<verilog::name_id>(m_tokens.size());
+        m_tokens.push_back(name);
+        m_names.push_back(name.to_string());
+        m_slots[slot] = std::make_pair(id, static_cast<std::uint32_t>(name_hash));
+        if(2*m_tokens.size() > m_slots.size())
+            grow(2*m_slots.size());
+        return id;
     }
+};
 
-    return valid;
-}
-
-bool verilog::read_wire(std::istream &in, std::string &token)
-{
-    token = "";
-
-    std::vector<std::string> tokens;
-    bool valid = read_line_as_tokens(in, tokens);
-
-    assert(valid);
-    assert(tokens.size() == 2);
+const verilog::name_id name_table::empty = std::numeric_limits<verilog::name_id>::max();
 
-    if (valid && tokens[0] == "wire")
-    {
-        token = tokens[1];
-    }
-    else
-    {
-        assert (tokens[0] == "Start" && tokens[1] == "cells");
-        return false;
-    }
-
-    return valid;
 }
 
-
 void verilog::read(const std::string &filename)
 {
     boost::posix_time::ptime mst1 = boost::posix_time::microsec_clock::local_time();
 
     std::cout << "reading .v file..." << std::endl;
 
-    std::ifstream file(filename);
-    std::stringstream in;
-    in << file.rdbuf();
-    file.close();
+    mapped_file file(filename);
+    read(file.data(), file.size());
 
-    m_pin_count = 0;
-    m_net_count = 0;
-
-    bool valid = read_module(in, m_design);
-    assert(valid);
-
-    std::unordered_set<std::string> nets;
+    boost::posix_time::ptime mst2 = boost::posix_time::microsec_clock::local_time();
+    boost::posix_time::time_duration msdiff = mst2 - mst1;
+    std::cout << "verilog::verilog(): " << msdiff.total_milliseconds() << " ms" << std::endl;
 
+}
 
-    std::string token;
-    do
-    {
-        valid = read_primary_input(in, token);
-        std::unordered_set<std::string> nets;
-        if(valid)
+void verilog::read(const char *data, std::size_t size)
+{
+    token_stream in(data, data+size);
+    name_table intern(m_names, size/32); // a name for every few dozen characters
+    std::vector<token> statement;
+    statement.reserve(64);
+    std::vector<char> is_net;
+    auto add_net = [this, &is_net](name_id net) {
+        if(net >= is_net.size())
+            is_net.resize(std::max(2*is_net.size(), m_names.size()), 0);
+        if(!is_net[net])
         {
-            m_inputs.push_back(token);
-            m_pin_count++;
-            nets.insert(token);
+            is_net[net] = 1;
+            m_net_ids.push_back(net);
         }
-    } while (valid);
+    };
 
-    do
+    token current;
+    while(in.next(current))
     {
-        valid = read_primary_output(in, token);
-        std::unordered_set<std::string> nets;
-        if(valid)
+        if(current == "endmodule" && statement.empty())
+            break;
+        if(current != ";")
         {
-            m_outputs.push_back(token);
-            m_pin_count++;
-            nets.insert(token);
+            statement.push_back(current);
+            continue;
         }
-    } while (valid);
-
-
-    do
-    {
-        valid = read_wire(in, token);
-        if(valid)
-            nets.insert(token);
-    } while (valid);
-
-
-
-
-    do {
-        std::string cellType, cellInst;
-        std::vector<std::pair<std::string, std::string> > pinNetPairs;   /* (port name, net name) */
-
-        valid = read_cell_inst(in, cellType, cellInst, pinNetPairs);
-        if (valid)
+        if(statement.empty())
+            continue;
+        const token & keyword = statement.front();
+        if(keyword == "module")
         {
-            for(auto pair : pinNetPairs)
-                nets.insert(pair.second);
-            module m;
-            m.name = cellInst;
-            m.type = cellType;
-            m.pinnet_pairs = pinNetPairs;
-            m_modules.push_back(m);
-            m_pin_count += pinNetPairs.size();
+            if(statement.size() > 1)
+                m_design = statement[1].to_string();
         }
+        else if(keyword == "input")
+        {
+            for(std::size_t i = 1; i < statement.size(); ++i)
+                m_input_ids.push_back(intern(statement[i]));
+        }
+        else if(keyword == "output")
+        {
+            for(std::size_t i = 1; i < statement.size(); ++i)
+                m_output_ids.push_back(intern(statement[i]));
+        }
+        else if(keyword == "wire")
+        {
+            for(std::size_t i = 1; i < statement.size(); ++i)
+                add_net(intern(statement[i]));
+        }
+        else if(statement.size() >= 2)
+        {
+            instance cell{intern(statement[0]), intern(statement[1]), m_instance_pins.size(), 0};
+            for(std::size_t i = 2; i < statement.size(); ++i)
+            {
+                if(statement[i].front() != '.' || i+1 == statement.size() || statement[i+1].front() == '.')
+                    continue; // unconnected pin
+                const name_id net = intern(statement[i+1]);
+                m_instance_pins.push_back(std::make_pair(intern(statement[i].substr(1)), net));
+                add_net(net);
+                ++i;
+            }
+            cell.pins_end = m_instance_pins.size();
+            m_instances.push_back(cell);
+        }
+        statement.clear();
+    }
 
-    } while(valid);
-
-    m_wires.insert(m_wires.end(), nets.begin(), nets.end());
-    m_net_count = m_wires.size();
-
-    boost::posix_time::ptime mst2 = boost::posix_time::microsec_clock::local_time();
-    boost::posix_time::time_duration msdiff = mst2 - mst1;
-    std::cout << "verilog::verilog(): " << msdiff.total_milliseconds() << " ms" << std::endl;
+    m_inputs.reserve(m_input_ids.size());
+    for(auto input : m_input_ids)
+        m_inputs.push_back(m_names[input]);
+    m_outputs.reserve(m_output_ids.size());
+    for(auto output : m_output_ids)
+        m_outputs.push_back(m_names[output]);
 
+    m_pin_count = m_input_ids.size() + m_output_ids.size() + m_instance_pins.size();
+    m_net_count = m_net_ids.size();
 }
 
 verilog::verilog(const std::string &filename) :
@@ -327,6 +328,32 @@ verilog::~verilog()
 
 }
 
+const std::vector<std::string> & verilog::wires() const
+{
+    std::call_once(m_wires_built, [this]() {
+        m_wires.reserve(m_net_ids.size());
+        for(auto net : m_net_ids)
+            m_wires.push_back(m_names[net]);
+    });
+    return m_wires;
 }
+
+const std::vector<verilog::module> & verilog::modules() const
+{
+    std::call_once(m_modules_built, [this]() {
+        m_modules.reserve(m_instances.size());
+        for(auto & cell : m_instances)
+        {
+            module m;
+            m.type = m_names[cell.type];
+            m.name = m_names[cell.name];
+            for(std::size_t i = cell.pins_begin; i < cell.pins_end; ++i)
+                m.pinnet_pairs.push_back(std::make_pair(m_names[m_instance_pins[i].first], m_names[m_instance_pins[i].second]));
+            m_modules.push_back(std::move(m));
+        }
+    });
+    return m_modules;
 }
 
+}
+}
@@ -24,13 +24,25 @@ under the License.
 #include <string>
 #include <vector>
 #include <utility>
+#include <cstdint>
+#include <mutex>
 
 namespace ophidian {
 namespace parsing {
 
+/// Structural verilog reader.
+/**
+ * The file is memory mapped and split into statements without copying it.
+ * Every cell, cell type, pin and net name is stored once in a table of
+ * interned names and the netlist refers to names by their index in it.
+ * modules() and wires() are a string based view of the same netlist, built
+ * once on their first call; concurrent first calls are safe.
+ */
 class verilog
 {
 public:
+    using name_id = std::uint32_t;
+
     struct module {
         std::string type;
         std::string name;
@@ -50,28 +62,34 @@ public:
         }
     };
 
+    struct instance {
+        name_id type;
+        name_id name;
+        std::size_t pins_begin; // range in instance_pins()
+        std::size_t pins_end;
+    };
+
 private:
     std::string m_design;
+    std::vector<std::string> m_names;
+    std::vector<name_id> m_input_ids;
+    std::vector<name_id> m_output_ids;
+    std::vector<name_id> m_net_ids;
+    std::vector<instance> m_instances;
+    std::vector< std::pair<name_id, name_id> > m_instance_pins;
+
     std::vector<std::string> m_inputs;
     std::vector<std::string> m_outputs;
-    std::vector<std::string> m_wires;
-    std::vector<module> m_modules;
+    mutable std::vector<std::string> m_wires;
+    mutable std::vector<module> m_modules;
+    mutable std::once_flag m_wires_built;
+    mutable std::once_flag m_modules_built;
 
     std::size_t m_pin_count;
     std::size_t m_net_count;
 
-    std::vector<std::string> tokenize(std::string line);
-
-    bool read_line_as_tokens(std::istream &in, std::vector<std::string> & tokens);
-    bool read_module(std::istream & in, std::string & token);
-    bool read_primary_input(std::istream & in, std::string & token);
-    bool read_primary_output(std::istream & in, std::string & token);
-    bool read_cell_inst(std::istream & in, std::string &cell_type, std::string &cell_inst, std::vector<std::pair<std::string, std::string> > &pin_net_pairs);
-
-
-    bool read_wire(std::istream & in, std::string & token);
-
     void read(const std::string & filename);
+    void read(const char * data, std::size_t size);
 
 
 public:
@@ -90,16 +108,38 @@ public:
         return m_outputs;
     }
 
-    const std::vector<std::string> & wires() const {
-        return m_wires;
+    const std::vector<std::string> & wires() const;
+    const std::vector<module> & modules() const;
+
+    /// Interned names, indexed by name_id.
+    const std::vector<std::string> & names() const {
+        return m_names;
+    }
+
+    const std::vector<name_id> & input_ids() const {
+        return m_input_ids;
+    }
+
+    const std::vector<name_id> & output_ids() const {
+        return m_output_ids;
+    }
+
+    /// Declared wires and nets connected to cells, in order of appearance.
+    const std::vector<name_id> & net_ids() const {
+        return m_net_ids;
+    }
+
+    const std::vector<instance> & instances() const {
+        return m_instances;
     }
 
-    const std::vector<module> & modules() const {
-        return m_modules;
+    /// (pin name, net) pairs of all instances.
+    const std::vector< std::pair<name_id, name_id> > & instance_pins() const {
+        return m_instance_pins;
     }
 
     std::size_t cell_count() const {
-        return m_modules.size();
+        return m_instances.size();
     }
 
     std::size_t net_count() const {
@@ -25,7 +25,6 @@ namespace placement {
 
 cells::cells(netlist::netlist * netlist) : m_system(netlist->cell_system()), m_fixed(false) {
 	netlist->register_cell_property(&m_positions);
-	netlist->register_cell_property(&m_geometries);
 	netlist->register_cell_property(&m_fixed);
 }
 
@@ -36,11 +35,6 @@ void cells::position(entity_system::entity cell, point position) {
 	m_positions[m_system.lookup(cell)] = position;
 }
 
-void cells::geometry(entity_system::entity cell,
-        multipolygon geometry) {
-    m_geometries[m_system.lookup(cell)] = geometry;
-}
-
 void cells::fixed(entity_system::entity cell, bool fixed) {
 	m_fixed[m_system.lookup(cell)] = fixed;
 }
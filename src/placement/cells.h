@@ -37,7 +37,6 @@ class cells  {
 
     const entity_system::entity_system & m_system;
 
-    entity_system::vector_property<multipolygon> m_geometries;
     entity_system::vector_property<point> m_positions;
     entity_system::vector_property<bool> m_fixed;
 
@@ -49,22 +48,17 @@ public:
     point position(entity_system::entity cell) const {
 		return m_positions[m_system.lookup(cell)];
 	}
-	const entity_system::vector_property<point> positions() const {
+	const entity_system::vector_property<point> & positions() const {
 		return m_positions;
 	}
 
-    void geometry(entity_system::entity cell, multipolygon geometry);
-    multipolygon geometry(entity_system::entity cell) const {
-        return m_geometries[m_system.lookup(cell)];
-    }
-    const entity_system::vector_property<multipolygon> geometries() const {
-        return m_geometries;
-    }
-
     void fixed(entity_system::entity cell, bool fixed);
     bool fixed(entity_system::entity cell) const {
 		return m_fixed[m_system.lookup(cell)];
 	}
+	const entity_system::vector_property<bool> & fixed() const {
+		return m_fixed;
+	}
 };
 
 } /* namespace placement */
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#include "incremental_hpwl.h"
+
+namespace ophidian {
+namespace placement {
+
+const std::size_t incremental_hpwl::none;
+
+incremental_hpwl::incremental_hpwl(const placement & place)
+    : m_cell_system(place.netlist().cell_system()), m_net_system(place.netlist().net_system()), m_value(0.0), m_updates(0) {
+    auto & netlist = place.netlist();
+    const std::size_t net_count = m_net_system.size();
+    const std::size_t cell_count = m_cell_system.size();
+
+    m_net_begin.reserve(net_count + 1);
+    m_net_begin.push_back(0);
+    m_cell_pin_begin.assign(cell_count + 1, 0);
+    for (auto net : m_net_system) {
+        for (auto pin : netlist.net_pins(net)) {
+            auto owner = netlist.pin_owner(pin);
+            if (owner == entity_system::invalid_entity) {
+                m_pads.push_back(std::make_pair(m_pin_cell.size(), pin));
+                m_pin_cell.push_back(none);
+                m_pin_offset.push_back(point(0.0, 0.0)); // set by recompute()
+            } else {
+                std::size_t cell = m_cell_system.lookup(owner);
+                m_pin_cell.push_back(cell);
+                m_pin_offset.push_back(place.lib().pin_offset(netlist.pin_std_cell(pin)));
+                m_cell_pin_begin[cell + 1]++;
+            }
+        }
+        m_net_begin.push_back(m_pin_cell.size());
+    }
+
+    for (std::size_t cell = 0; cell < cell_count; ++cell) {
+        m_cell_pin_begin[cell + 1] += m_cell_pin_begin[cell];
+    }
+    m_cell_pins.resize(m_cell_pin_begin.back());
+    // filled net by net, so the pins of a cell on the same net are next to each other
+    std::vector<std::size_t> next(m_cell_pin_begin.begin(), m_cell_pin_begin.end() - 1);
+    for (std::size_t net = 0; net < net_count; ++net) {
+        for (std::size_t pin = m_net_begin[net]; pin < m_net_begin[net + 1]; ++pin) {
+            if (m_pin_cell[pin] != none) {
+                m_cell_pins[next[m_pin_cell[pin]]++] = std::make_pair(net, pin);
+            }
+        }
+    }
+
+    m_cell_positions.resize(cell_count);
+    m_boxes.resize(net_count);
+    m_touched.assign(net_count, 0);
+    recompute(place);
+}
+
+void incremental_hpwl::compute_net(std::size_t net) {
+    bounding_box & box = m_boxes[net];
+    box = bounding_box{0.0, 0.0, 0.0, 0.0, 0, 0, 0, 0};
+    if (m_net_begin[net] == m_net_begin[net + 1]) {
+        return;
+    }
+    point first = pin_position(m_net_begin[net]);
+    box.lower_x = box.upper_x = first.x();
+    box.lower_y = box.upper_y = first.y();
+    for (std::size_t pin = m_net_begin[net] + 1; pin < m_net_begin[net + 1]; ++pin) {
+        point position = pin_position(pin);
+        box.lower_x = std::min(box.lower_x, position.x());
+        box.upper_x = std::max(box.upper_x, position.x());
+        box.lower_y = std::min(box.lower_y, position.y());
+        box.upper_y = std::max(box.upper_y, position.y());
+    }
+    for (std::size_t pin = m_net_begin[net]; pin < m_net_begin[net + 1]; ++pin) {
+        point position = pin_position(pin);
+        box.lower_x_pins += position.x() == box.lower_x;
+        box.upper_x_pins += position.x() == box.upper_x;
+        box.lower_y_pins += position.y() == box.lower_y;
+        box.upper_y_pins += position.y() == box.upper_y;
+    }
+}
+
+namespace {
+
+// moves one pin across an edge; returns false when the edge lost its last pin and must be recomputed
+bool move_lower(double & edge, std::size_t & pins, double old_coordinate, double new_coordinate) {
+    if (new_coordinate < edge) {
+        edge = new_coordinate;
+        pins = 1;
+    } else if (new_coordinate == edge) {
+        pins += old_coordinate != edge;
+    } else if (old_coordinate == edge) {
+        return --pins > 0;
+    }
+    return true;
+}
+
+bool move_upper(double & edge, std::size_t & pins, double old_coordinate, double new_coordinate) {
+    if (new_coordinate > edge) {
+        edge = new_coordinate;
+        pins = 1;
+    } else if (new_coordinate == edge) {
+        pins += old_coordinate != edge;
+    } else if (old_coordinate == edge) {
+        return --pins > 0;
+    }
+    return true;
+}
+
+}
+
+bool incremental_hpwl::move_pin(std::size_t net, point old_position, point new_position) {
+    bounding_box & box = m_boxes[net];
+    bool valid = move_lower(box.lower_x, box.lower_x_pins, old_position.x(), new_position.x());
+    valid = move_upper(box.upper_x, box.upper_x_pins, old_position.x(), new_position.x()) && valid;
+    valid = move_lower(box.lower_y, box.lower_y_pins, old_position.y(), new_position.y()) && valid;
+    valid = move_upper(box.upper_y, box.upper_y_pins, old_position.y(), new_position.y()) && valid;
+    return valid;
+}
+
+void incremental_hpwl::cell_moved(entity_system::entity cell, point position) {
+    const std::size_t cell_index = m_cell_system.lookup(cell);
+    const point old_position = m_cell_positions[cell_index];
+    m_cell_positions[cell_index] = position;
+    const std::size_t begin = m_cell_pin_begin[cell_index];
+    const std::size_t end = m_cell_pin_begin[cell_index + 1];
+    for (std::size_t index = begin; index < end; ++index) {
+        const std::size_t net = m_cell_pins[index].first;
+        const std::size_t pin = m_cell_pins[index].second;
+        // a cell with several pins on a net moves them all at once, so the net is recomputed once
+        if (index > begin && m_cell_pins[index - 1].first == net) {
+            continue;
+        }
+        const bool shared = index + 1 < end && m_cell_pins[index + 1].first == net;
+        const double before = half_perimeter(m_boxes[net]);
+        const point offset = m_pin_offset[pin];
+        if (shared || !move_pin(net, point(old_position.x() + offset.x(), old_position.y() + offset.y()), point(position.x() + offset.x(), position.y() + offset.y()))) {
+            compute_net(net);
+        }
+        m_value += half_perimeter(m_boxes[net]) - before;
+    }
+    add_updates(end - begin);
+}
+
+void incremental_hpwl::cells_moved(const std::vector<entity_system::entity> & cells, const std::vector<point> & positions) {
+    std::vector<std::size_t> nets;
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        const std::size_t cell_index = m_cell_system.lookup(cells[i]);
+        m_cell_positions[cell_index] = positions[i];
+        for (std::size_t index = m_cell_pin_begin[cell_index]; index < m_cell_pin_begin[cell_index + 1]; ++index) {
+            const std::size_t net = m_cell_pins[index].first;
+            if (!m_touched[net]) {
+                m_touched[net] = 1;
+                nets.push_back(net);
+            }
+        }
+    }
+
+    double delta = 0.0;
+#pragma omp parallel for schedule(dynamic, 256) reduction(+:delta)
+    for (std::size_t i = 0; i < nets.size(); ++i) {
+        const double before = half_perimeter(m_boxes[nets[i]]);
+        compute_net(nets[i]);
+        delta += half_perimeter(m_boxes[nets[i]]) - before;
+        m_touched[nets[i]] = 0;
+    }
+    m_value += delta;
+    add_updates(nets.size());
+}
+
+void incremental_hpwl::add_updates(std::size_t updates) {
+    m_updates += updates;
+    if (m_updates < m_boxes.size()) {
+        return;
+    }
+    double value = 0.0;
+#pragma omp parallel for schedule(static) reduction(+:value)
+    for (std::size_t net = 0; net < m_boxes.size(); ++net) {
+        value += half_perimeter(m_boxes[net]);
+    }
+    m_value = value;
+    m_updates = 0;
+}
+
+void incremental_hpwl::recompute(const placement & place) {
+    for (auto cell : m_cell_system) {
+        m_cell_positions[m_cell_system.lookup(cell)] = place.cell_position(cell);
+    }
+    for (auto & pad : m_pads) {
+        m_pin_offset[pad.first] = place.pin_position(pad.second);
+    }
+
+    double value = 0.0;
+#pragma omp parallel for schedule(dynamic, 256) reduction(+:value)
+    for (std::size_t net = 0; net < m_boxes.size(); ++net) {
+        compute_net(net);
+        value += half_perimeter(m_boxes[net]);
+    }
+    m_value = value;
+    m_updates = 0;
+}
+
+}
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#ifndef OPHIDIAN_PLACEMENT_INCREMENTAL_HPWL_H
+#define OPHIDIAN_PLACEMENT_INCREMENTAL_HPWL_H
+
+#include <limits>
+#include "placement.h"
+
+namespace ophidian {
+namespace placement {
+
+/// Incremental half-perimeter wirelength.
+/**
+ * Keeps the bounding box of every net together with the number of pins lying on each of its edges.
+ * Moving a cell updates the boxes of its nets in constant time, unless the cell was the only pin on
+ * an edge it moves away from, in which case that net alone is recomputed. Pin offsets and cell positions
+ * are cached, so updates do not look up the placement, the netlist or the library; pads are only reloaded
+ * by recompute(). The boxes are exact; the total is kept by adding differences and is summed again from
+ * the boxes after as many net updates as there are nets, so rounding errors do not build up.
+ */
+class incremental_hpwl {
+    using point = geometry::point<double>;
+    static const std::size_t none = std::numeric_limits<std::size_t>::max();
+
+    struct bounding_box {
+        double lower_x, upper_x, lower_y, upper_y;
+        std::size_t lower_x_pins, upper_x_pins, lower_y_pins, upper_y_pins;
+    };
+
+    const entity_system::entity_system & m_cell_system;
+    const entity_system::entity_system & m_net_system;
+
+    // pins grouped by net: owner cell index, or none for pads, and offset from the owner or absolute position
+    std::vector<std::size_t> m_net_begin;
+    std::vector<std::size_t> m_pin_cell;
+    std::vector<point> m_pin_offset;
+    std::vector<std::pair<std::size_t, entity_system::entity> > m_pads; // (pin index, pin) of pad pins
+
+    // pins of each cell as (net index, pin index), sorted by net
+    std::vector<std::size_t> m_cell_pin_begin;
+    std::vector<std::pair<std::size_t, std::size_t> > m_cell_pins;
+
+    std::vector<point> m_cell_positions;
+    std::vector<bounding_box> m_boxes;
+    std::vector<char> m_touched;
+    double m_value;
+    std::size_t m_updates; // net updates since the total was last summed from the boxes
+
+    point pin_position(std::size_t pin) const {
+        if (m_pin_cell[pin] == none) {
+            return m_pin_offset[pin];
+        }
+        const point & cell = m_cell_positions[m_pin_cell[pin]];
+        return point(cell.x() + m_pin_offset[pin].x(), cell.y() + m_pin_offset[pin].y());
+    }
+
+    static double half_perimeter(const bounding_box & box) {
+        return (box.upper_x - box.lower_x) + (box.upper_y - box.lower_y);
+    }
+
+    void compute_net(std::size_t net);
+    bool move_pin(std::size_t net, point old_position, point new_position);
+    void add_updates(std::size_t updates);
+public:
+    /// Constructor.
+    /**
+     * Caches the pins of every net and the current cell positions, and computes all bounding boxes.
+     * \param place Placement of the circuit.
+     */
+    incremental_hpwl(const placement & place);
+
+    /// Total wirelength.
+    double value() const {
+        return m_value;
+    }
+
+    /// Wirelength of a net.
+    double net_value(entity_system::entity net) const {
+        return half_perimeter(m_boxes[m_net_system.lookup(net)]);
+    }
+
+    /// Updates the nets of a moved cell.
+    /**
+     * \param cell Moved cell.
+     * \param position New position of the cell.
+     */
+    void cell_moved(entity_system::entity cell, point position);
+
+    /// Updates the nets of several moved cells, recomputing each touched net once and in parallel.
+    /**
+     * \param cells Moved cells.
+     * \param positions New position of each cell.
+     */
+    void cells_moved(const std::vector<entity_system::entity> & cells, const std::vector<point> & positions);
+
+    /// Reloads every cell and pad position from the placement and recomputes all nets in parallel.
+    void recompute(const placement & place);
+};
+
+}
+}
+
+#endif // OPHIDIAN_PLACEMENT_INCREMENTAL_HPWL_H
@@ -26,6 +26,8 @@ namespace placement {
 library::library(ophidian::standard_cell::standard_cells * std_cells) :
     m_std_cells(*std_cells) {
     std_cells->register_cell_property(&m_cell_geometry);
+    std_cells->register_cell_property(&m_cell_rectangles);
+    std_cells->register_cell_property(&m_cell_bounds);
     std_cells->register_pin_property(&m_pin_offset);
 }
 
@@ -33,7 +35,21 @@ library::~library() {
 }
 
 void library::geometry(entity_system::entity cell, multipolygon geometry) {
-    m_cell_geometry[m_std_cells.cell_system().lookup(cell)] = geometry;
+    auto cell_index = m_std_cells.cell_system().lookup(cell);
+    std::vector<box> rectangles;
+    rectangles.reserve(geometry.size());
+    for (auto & cell_polygon : geometry) {
+        box rectangle;
+        boost::geometry::envelope(cell_polygon, rectangle);
+        rectangles.push_back(rectangle);
+    }
+    box bounds(point(0.0, 0.0), point(0.0, 0.0));
+    if (!geometry.empty()) {
+        boost::geometry::envelope(geometry, bounds);
+    }
+    m_cell_geometry[cell_index] = std::move(geometry);
+    m_cell_rectangles[cell_index] = std::move(rectangles);
+    m_cell_bounds[cell_index] = bounds;
 }
 
 entity_system::entity library::cell_create(std::string name)
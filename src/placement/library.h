@@ -44,9 +44,12 @@ class library {
 	using point = geometry::point<double>;
 	using polygon = geometry::polygon<point>;
 	using multipolygon = geometry::multi_polygon<polygon>;
+	using box = geometry::box<point>;
 
     ophidian::standard_cell::standard_cells & m_std_cells;
     entity_system::vector_property< multipolygon > m_cell_geometry;
+    entity_system::vector_property< std::vector<box> > m_cell_rectangles;
+    entity_system::vector_property< box > m_cell_bounds;
     entity_system::vector_property< point > m_pin_offset;
 
     int32_t m_dist2microns;
@@ -66,12 +69,30 @@ public:
 	 * \param cell Cell to get the geometry.
 	 * \return Multi polygon representing the cell geometry.
 	 */
-    multipolygon geometry(entity_system::entity cell) const {
+    const multipolygon & geometry(entity_system::entity cell) const {
         return m_cell_geometry[m_std_cells.cell_system().lookup(cell)];
 	}
+	/// Cell rectangles getter.
+	/**
+	 * Returns the bounding box of each polygon of the cell geometry, relative to the cell origin.
+	 * \param cell Cell to get the rectangles.
+	 * \return Vector with one box per polygon of the cell geometry.
+	 */
+    const std::vector<box> & rectangles(entity_system::entity cell) const {
+        return m_cell_rectangles[m_std_cells.cell_system().lookup(cell)];
+	}
+	/// Cell bounds getter.
+	/**
+	 * Returns the bounding box of the whole cell geometry, relative to the cell origin.
+	 * \param cell Cell to get the bounds.
+	 * \return Box enclosing the cell geometry.
+	 */
+    const box & bounds(entity_system::entity cell) const {
+        return m_cell_bounds[m_std_cells.cell_system().lookup(cell)];
+	}
 	/// Cell geometry setter.
 	/**
-	 * Sets the geometry of a cell.
+	 * Sets the geometry of a cell and computes its rectangles and bounds.
 	 * \param cell Cell to set the geometry.
 	 * \param geometry Multi polygon representing the cell geometry.
 	 */
@@ -24,7 +24,7 @@ namespace ophidian {
 namespace placement {
 
 placement::placement(netlist::netlist* netlist, library* lib) :
-    m_netlist(netlist), m_library(lib), m_cells(netlist) {
+    m_netlist(netlist), m_library(lib), m_cells(netlist), m_pin_positions_cached(false) {
 }
 
 placement::~placement() {
@@ -34,16 +34,59 @@ void placement::cell_position(entity_system::entity cell,
                               geometry::point<double> position) {
     if (!cell_fixed(cell)) {
         m_cells.position(cell, position);
-        auto lib_geometry = m_library->geometry(m_netlist->cell_std_cell(cell));
-        geometry::multi_polygon<geometry::polygon<geometry::point<double> > > translated;
-        geometry::translate(lib_geometry, position, translated);
-        m_cells.geometry(cell, translated);
+        if (m_pin_positions_cached) {
+            auto & pin_system = m_netlist->pin_system();
+            for (auto pin : m_netlist->cell_pins(cell)) {
+                auto pin_index = pin_system.lookup(pin);
+                m_pin_positions[pin_index] = geometry::point<double>(position.x() + m_pin_offsets[pin_index].x(), position.y() + m_pin_offsets[pin_index].y());
+            }
+        }
     }
 }
 
 void placement::pad_position(entity_system::entity pad,
                              geometry::point<double> position) {
     m_library->pin_offset(m_netlist->pin_std_cell(pad), position);
+    if (m_pin_positions_cached) {
+        auto pin_index = m_netlist->pin_system().lookup(pad);
+        m_pin_offsets[pin_index] = position;
+        m_pin_positions[pin_index] = position;
+    }
+}
+
+void placement::cache_pin_positions() {
+    if (!m_pin_positions_cached) {
+        m_netlist->register_pin_property(&m_pin_positions);
+        m_netlist->register_pin_property(&m_pin_offsets);
+        m_netlist->register_pin_property(&m_pin_owners);
+        m_pin_positions_cached = true;
+    }
+
+    auto & pin_system = m_netlist->pin_system();
+    auto & cell_system = m_netlist->cell_system();
+    for (auto pin : pin_system) {
+        auto pin_index = pin_system.lookup(pin);
+        auto owner = m_netlist->pin_owner(pin);
+        m_pin_offsets[pin_index] = m_library->pin_offset(m_netlist->pin_std_cell(pin));
+        m_pin_owners[pin_index] = owner == entity_system::invalid_entity ? entity_system::invalid_entity_index : cell_system.lookup(owner);
+    }
+
+    // a flat gather of owner positions plus offsets
+    const geometry::point<double> * cell_positions = m_cells.positions().data();
+    const geometry::point<double> * offsets = m_pin_offsets.data();
+    const entity_system::entity_index * owners = m_pin_owners.data();
+    geometry::point<double> * positions = m_pin_positions.data();
+    const std::size_t pin_count = pin_system.size();
+#pragma omp parallel for schedule(static)
+    for (std::size_t pin_index = 0; pin_index < pin_count; ++pin_index) {
+        double x = offsets[pin_index].x();
+        double y = offsets[pin_index].y();
+        if (owners[pin_index] != entity_system::invalid_entity_index) {
+            x += cell_positions[owners[pin_index]].x();
+            y += cell_positions[owners[pin_index]].y();
+        }
+        positions[pin_index] = geometry::point<double>(x, y);
+    }
 }
 
 void placement::cell_fixed(entity_system::entity cell, bool fixed) {
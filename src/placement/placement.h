@@ -36,6 +36,11 @@ class placement {
 	netlist::netlist * m_netlist;
 	library * m_library;
 	cells m_cells;
+
+	bool m_pin_positions_cached;
+	entity_system::vector_property<geometry::point<double> > m_pin_positions;
+	entity_system::vector_property<geometry::point<double> > m_pin_offsets;
+	entity_system::vector_property<entity_system::entity_index> m_pin_owners;
 public:
 	/// Constructor.
 	/**
@@ -48,17 +53,39 @@ public:
 	/// Cell geometry getter.
 	/**
 	 * Returns the geometry of a cell as a multi polygon. Each polygon in the multi polygon represents a rectangle of the cell.
+	 * The geometry is built from the library on each call; prefer cell_rectangles() or cell_box() in hot loops.
 	 * \param cell Cell to get the geometry.
 	 * \return Multi polygon with the cell geometry.
 	 */
 	geometry::multi_polygon<geometry::polygon<geometry::point<double> > > cell_geometry(
             entity_system::entity cell) const {
         auto position = cell_position(cell);
-        auto lib_geometry = m_library->geometry(m_netlist->cell_std_cell(cell));
         geometry::multi_polygon<geometry::polygon<geometry::point<double> > > translated;
-        geometry::translate(lib_geometry, position, translated);
+        geometry::translate(m_library->geometry(m_netlist->cell_std_cell(cell)), position, translated);
         return translated;
 	}
+	/// Cell rectangles getter.
+	/**
+	 * Returns the rectangles of a cell relative to its position, one per polygon of its geometry. Nothing is translated or copied.
+	 * \param cell Cell to get the rectangles.
+	 * \return Vector of boxes relative to the cell position.
+	 */
+	const std::vector<geometry::box<geometry::point<double> > > & cell_rectangles(entity_system::entity cell) const {
+		return m_library->rectangles(m_netlist->cell_std_cell(cell));
+	}
+	/// Cell box getter.
+	/**
+	 * Returns the bounding box of a cell at its current position.
+	 * \param cell Cell to get the box.
+	 * \return Box enclosing the cell geometry.
+	 */
+	geometry::box<geometry::point<double> > cell_box(entity_system::entity cell) const {
+		auto position = cell_position(cell);
+		auto & bounds = m_library->bounds(m_netlist->cell_std_cell(cell));
+		return geometry::box<geometry::point<double> >(
+				geometry::point<double>(position.x() + bounds.min_corner().x(), position.y() + bounds.min_corner().y()),
+				geometry::point<double>(position.x() + bounds.max_corner().x(), position.y() + bounds.max_corner().y()));
+	}
 	/// Places a cell.
 	/**
 	 * Changes the position of a cell.
@@ -81,16 +108,18 @@ public:
 		return m_cells.fixed(cell);
 	}
 	geometry::point<double> cell_dimensions(entity_system::entity cell) const {
-		auto geometry = cell_geometry(cell);
-		geometry::box<geometry::point<double>> cell_box;
-		boost::geometry::envelope(geometry, cell_box);
-		geometry::point<double> dimensions(cell_box.max_corner().x() - cell_box.min_corner().x(), cell_box.max_corner().y() - cell_box.min_corner().y());
-		return dimensions;
+		auto & bounds = m_library->bounds(m_netlist->cell_std_cell(cell));
+		return geometry::point<double>(bounds.max_corner().x() - bounds.min_corner().x(), bounds.max_corner().y() - bounds.min_corner().y());
 	}
 
     entity_system::entity cell_create(std::string name, std::string type);
 
-	const cells & cell_properties() { return m_cells; };
+	/// Cell properties getter.
+	/**
+	 * Returns the cell properties. Their positions() and fixed() accessors give the values of every cell without copying, indexed like the cell system.
+	 * \return Constant reference to the cell properties.
+	 */
+	const cells & cell_properties() const { return m_cells; };
 
 	/// Pin position getter.
 	/**
@@ -99,6 +128,8 @@ public:
 	 * \return Point describing the pin position.
 	 */
     geometry::point<double> pin_position(entity_system::entity pin) const {
+        if(m_pin_positions_cached)
+            return m_pin_positions[m_netlist->pin_system().lookup(pin)];
         entity_system::entity owner = m_netlist->pin_owner(pin);
         entity_system::entity std_cell_pin = m_netlist->pin_std_cell(pin);
 
@@ -120,6 +151,28 @@ public:
 	 */
     void pad_position(entity_system::entity pad, geometry::point<double> position);
 
+	/// Caches pin positions.
+	/**
+	 * Stores the absolute position of every pin in a property indexed like the pin system, which pin_position() reads from then on.
+	 * Moving cells and pads keeps the cache up to date. Call it again after inserting or removing pins or cells, or after changing pin offsets in the library.
+	 */
+	void cache_pin_positions();
+
+	/// Returns whether pin positions are cached.
+	bool pin_positions_cached() const {
+		return m_pin_positions_cached;
+	}
+
+	/// Cached pin positions getter.
+	/**
+	 * Returns the cached absolute pin positions, stored contiguously and indexed like the pin system.
+	 * Only valid after cache_pin_positions().
+	 * \return Constant reference to the pin positions property.
+	 */
+	const entity_system::vector_property<geometry::point<double> > & pin_positions() const {
+		return m_pin_positions;
+	}
+
 
 	/// Netlist getter.
 	/**
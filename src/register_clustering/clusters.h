@@ -68,16 +68,16 @@ public:
         return m_flip_flops[m_system.lookup(cluster)];
     }
 
-    std::pair<std::vector<std::vector<cluster_element>>::const_iterator, std::vector<std::vector<cluster_element>>::const_iterator> flip_flops() const {
-        return std::make_pair(m_flip_flops.begin(), m_flip_flops.end());
+    const entity_system::vector_property<std::vector<cluster_element>> & flip_flops() const {
+        return m_flip_flops;
     }
 
     point center(entity_system::entity cluster) const {
         return m_centers[m_system.lookup(cluster)];
     }
 
-    std::pair<std::vector<point>::const_iterator, std::vector<point>::const_iterator> centers() const {
-        return std::make_pair(m_centers.begin(), m_centers.end());
+    const entity_system::vector_property<point> & centers() const {
+        return m_centers;
     }
 
     entity_system::entity cluster(entity_system::entity flip_flop) {
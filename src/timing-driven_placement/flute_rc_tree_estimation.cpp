@@ -21,6 +21,8 @@ under the License.
 #include "flute_rc_tree_estimation.h"
 #include "../interconnection/flute.h"
 
+#include <cstdlib>
+
 #include  <boost/geometry/algorithms/equals.hpp>
 #include <boost/units/systems/si/prefixes.hpp>
 #include <boost/geometry.hpp>
@@ -47,10 +49,7 @@ typedef boost::geometry::index::rtree<rtree_node, boost::geometry::index::rstar<
 
 flute_rc_tree_creator::flute_rc_tree_creator()
 {
-#pragma omp critical
-    {
     interconnection::readLUT();
-    }
     m_params.capacitance_per_micron = quantity<si::capacitance>(1.6e-16 * si::farads);
     m_params.resistance_per_micron = quantity<si::resistance>(2.535 * si::ohms);
 }
@@ -79,8 +78,6 @@ std::unordered_map<entity_system::entity, interconnection::rc_tree::capacitor_id
 //    params& param = (placement.netlist().net_name(net)=="iccad_clk"?dummy:m_params);
     params & param = m_params;
 
-    std::set< interconnection::rc_tree::capacitor_id > taps;
-
     if(net_pins.size() == 1)
     {
         auto pin_u = net_pins[0];
@@ -88,13 +85,12 @@ std::unordered_map<entity_system::entity, interconnection::rc_tree::capacitor_id
         auto u = rc_tree.capacitor_insert("C0");
         auto tap_u = rc_tree.capacitor_insert(placement.netlist().pin_name(pin_u));
         tap_mapping[pin_u] = tap_u;
-        taps.insert(tap_u);
         auto pin_cap_u = library.pin_capacitance(placement.netlist().pin_std_cell(pin_u));
         rc_tree.capacitance(tap_u, pin_cap_u);
         rc_tree.resistor_insert(u, tap_u, quantity<si::resistance>(0.0 * si::ohms));
 
-        for(auto t : taps)
-            rc_tree.tap_insert(t);
+        for(auto & t : tap_mapping)
+            rc_tree.tap_insert(t.second, t.first);
 
         return tap_mapping;
     }
@@ -119,8 +115,6 @@ std::unordered_map<entity_system::entity, interconnection::rc_tree::capacitor_id
         tap_mapping[pin_u] = tap_u;
         tap_mapping[pin_v] = tap_v;
 
-        taps.insert(tap_u);
-        taps.insert(tap_v);
 
 
 
@@ -133,8 +127,8 @@ std::unordered_map<entity_system::entity, interconnection::rc_tree::capacitor_id
         rc_tree.resistor_insert(v, tap_v, quantity<si::resistance>(0.0 * si::ohms));
 
 
-        for(auto t : taps)
-            rc_tree.tap_insert(t);
+        for(auto & t : tap_mapping)
+            rc_tree.tap_insert(t.second, t.first);
 
         return tap_mapping;
     }
@@ -194,7 +188,7 @@ std::unordered_map<entity_system::entity, interconnection::rc_tree::capacitor_id
             auto tap_cap = rc_tree.capacitor_insert(placement.netlist().pin_name(pin));
 
             tap_mapping[pin] = tap_cap;
-            rc_tree.tap_insert(tap_cap);
+            rc_tree.tap_insert(tap_cap, pin);
 
             auto pin_cap = library.pin_capacitance(placement.netlist().pin_std_cell(pin));
             rc_tree.capacitance(tap_cap, pin_cap); // tap pin capacitance
@@ -202,6 +196,7 @@ std::unordered_map<entity_system::entity, interconnection::rc_tree::capacitor_id
                 rc_tree.resistor_insert(cap_from, tap_cap, quantity<si::resistance>(0.0 * si::ohms));
         }
     }
+    free(tree.branch);
 
     return tap_mapping;
 }
@@ -143,6 +143,7 @@ timingdriven_placement::timingdriven_placement(const std::string & dot_verilog_f
 
     mst1 = boost::posix_time::microsec_clock::local_time();
     placement::def2placement(*def, m_placement);
+    m_placement.cache_pin_positions();
     mst2 = boost::posix_time::microsec_clock::local_time();
     msdiff = mst2 - mst1;
     std::cout << "cells placement (" << msdiff.total_milliseconds() << " ms)" << std::endl;
@@ -221,8 +222,9 @@ void timingdriven_placement::update_timing()
         m_sta->netlist(m_netlist);
         m_sta->set_constraints(m_dc);
     }
+    std::vector<Net> dirty_nets(m_dirty_nets.begin(), m_dirty_nets.end());
     update_dirty_rc_trees();
-    m_sta->update_timing();
+    m_sta->update_timing(dirty_nets);
 }
 
 }
@@ -40,6 +40,47 @@ under the License.
 namespace ophidian {
 namespace timing {
 
+/// Scratch storage for the wire delay models.
+/**
+ * Holds the per-node slews, delays and effective capacitances of one net. A
+ * workspace is meant to be kept by each thread and reused for every net it
+ * simulates, so after it has been reserved for the largest rc tree no more
+ * memory is allocated.
+ */
+struct wire_delay_workspace {
+    using CapacitanceType = boost::units::quantity < boost::units::si::capacitance >;
+    using SlewType = boost::units::quantity < boost::units::si::time >;
+
+    std::vector< SlewType > slews;
+    std::vector< SlewType > delays;
+    std::vector< CapacitanceType > ceffs;
+
+    explicit wire_delay_workspace(std::size_t node_count = 0) {
+        reserve(node_count);
+    }
+
+    void reserve(std::size_t node_count) {
+        slews.reserve(node_count);
+        delays.reserve(node_count);
+        ceffs.reserve(node_count);
+    }
+
+    /// Prepares the workspace for a tree and attaches it to a wire delay model.
+    /**
+     * The effective capacitances restart from zero, as expected by the
+     * effective capacitance iterations.
+     */
+    template <class WireDelayModel>
+    void attach(WireDelayModel & model, const interconnection::packed_rc_tree & tree) {
+        slews.resize(tree.node_count());
+        delays.resize(tree.node_count());
+        ceffs.assign(tree.node_count(), CapacitanceType());
+        model.slew_map(slews);
+        model.delay_map(delays);
+        model.ceff_map(ceffs);
+    }
+};
+
 
 class lumped_capacitance_wire_model {
     using CapacitanceType = boost::units::quantity < boost::units::si::capacitance >;
@@ -155,38 +196,42 @@ public:
 
 
 
+        // the kernel works on the raw values, in seconds, farads and ohms
+        const std::size_t node_count = tree.node_count();
+        const std::size_t * pred = tree.preds();
+        const double * resistance = tree.resistances();
+        const double * capacitance = tree.capacitances();
+
         double error = 1.0;
-        std::size_t iteration = 0;
 
         CapacitanceType current_ceff;
         delays[0] = SlewType(0.0*boost::units::si::seconds);
         while (error > m_precision) {
             current_ceff = ceff[0];
-            ////            std::cout << "iteration #" << iteration++ << " ceff " << current_ceff << std::endl;
             slews[0] = slew_calculator(current_ceff);
-            for(std::size_t current = 1; current < tree.node_count(); ++current)
+            for(std::size_t current = 1; current < node_count; ++current)
             {
-                auto parent = tree.pred(current);
-                auto resistance_with_parent = tree.resistance(current);
-
-                slews[current] = slews[parent];
-                if(slews[parent] > 0.0*boost::units::si::seconds){
-                    double x = resistance_with_parent*ceff[current]/slews[parent];
-                    slews[current] = slews[parent]/ (1-x*(1-std::exp(-1/x)));
+                const std::size_t parent = pred[current];
+                const double parent_slew = slews[parent].value();
+                const double wire_delay = resistance[current]*ceff[current].value();
+                double slew = parent_slew;
+                if(parent_slew > 0.0){
+                    double x = wire_delay/parent_slew;
+                    slew = parent_slew/ (1-x*(1-std::exp(-1/x)));
                 }
-                delays[current] = delays[parent] + resistance_with_parent*ceff[current];
+                slews[current] = SlewType::from_value(slew);
+                delays[current] = SlewType::from_value(delays[parent].value() + wire_delay);
             }
-            for(std::size_t node = 0; node < tree.node_count(); ++node)
-                ceff[node] = tree.capacitance(node);
-            for(std::size_t i = 0; i < tree.node_count()-1; ++i)
+            for(std::size_t node = 0; node < node_count; ++node)
+                ceff[node] = CapacitanceType::from_value(capacitance[node]);
+            for(std::size_t current = node_count-1; current > 0; --current)
             {
-                std::size_t current = tree.node_count() - (i+1);
-                auto parent = tree.pred(current);
-                auto resistance_with_parent = tree.resistance(current);
-                double x = 2.0 * resistance_with_parent  * ceff[current] / slews[parent];
+                const std::size_t parent = pred[current];
+                const double parent_slew = slews[parent].value();
+                double x = 2.0 * resistance[current] * ceff[current].value() / parent_slew;
                 double y = 1.0 - std::exp(-1.0/x);
-                double shielding_factor = (slews[parent] > 0.0*boost::units::si::seconds?1.0 - x * y:1.0);
-                ceff[parent] += shielding_factor*ceff[current];
+                double shielding_factor = (parent_slew > 0.0?1.0 - x * y:1.0);
+                ceff[parent] += CapacitanceType::from_value(shielding_factor*ceff[current].value());
             }
             error = boost::units::abs(current_ceff-ceff[0])/std::max(current_ceff, ceff[0]);
         }
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#include "csr_graph.h"
+
+#include <limits>
+
+namespace ophidian {
+namespace timing {
+
+csr_graph::csr_graph()
+{
+
+}
+
+csr_graph::csr_graph(const graph &g, const std::vector<graph::node> &order) :
+    m_nodes(order),
+    m_node_index(g.G().maxNodeId()+1, std::numeric_limits<index>::max()),
+    m_node_edges(order.size()),
+    m_pins(order.size()),
+    m_in_offsets(order.size()+1),
+    m_out_offsets(order.size()+1)
+{
+    const graph::graph_t & G = g.G();
+    for(std::size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        m_node_index[G.id(m_nodes[i])] = static_cast<index>(i);
+        m_node_edges[i] = g.node_edge(m_nodes[i]);
+        m_pins[i] = g.pin(m_nodes[i]);
+    }
+
+    const std::size_t arcs = g.edges_count();
+    m_arcs.reserve(arcs);
+    m_sources.reserve(arcs);
+    m_targets.reserve(arcs);
+    m_arc_types.reserve(arcs);
+    m_arc_entities.reserve(arcs);
+    std::vector< index > arc_index(G.maxArcId()+1);
+    for(std::size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        m_out_offsets[i] = static_cast<index>(m_arcs.size());
+        for(graph::graph_t::OutArcIt arc(G, m_nodes[i]); arc != lemon::INVALID; ++arc)
+        {
+            arc_index[G.id(arc)] = static_cast<index>(m_arcs.size());
+            m_arcs.push_back(arc);
+            m_sources.push_back(static_cast<index>(i));
+            m_targets.push_back(node_index(g.edge_target(arc)));
+            m_arc_types.push_back(g.edge_type(arc));
+            m_arc_entities.push_back(g.edge_entity(arc));
+        }
+    }
+    m_out_offsets[m_nodes.size()] = static_cast<index>(m_arcs.size());
+
+    m_in_arcs.reserve(m_arcs.size());
+    for(std::size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        m_in_offsets[i] = static_cast<index>(m_in_arcs.size());
+        for(graph::graph_t::InArcIt arc(G, m_nodes[i]); arc != lemon::INVALID; ++arc)
+            m_in_arcs.push_back(arc_index[G.id(arc)]);
+    }
+    m_in_offsets[m_nodes.size()] = static_cast<index>(m_in_arcs.size());
+}
+
+}
+}
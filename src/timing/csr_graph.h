@@ -0,0 +1,124 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#ifndef OPHIDIAN_TIMING_CSR_GRAPH_H
+#define OPHIDIAN_TIMING_CSR_GRAPH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "graph.h"
+
+namespace ophidian {
+namespace timing {
+
+/// Frozen compressed-sparse-row copy of a timing graph.
+/**
+ * Nodes are renumbered in the order given at construction (the STA uses a
+ * topological, level by level order) and arcs are numbered by source node, so
+ * the out-arcs of a node are a contiguous range of arc indices. In-arcs are
+ * stored as contiguous lists of arc indices, in the same order lemon iterates
+ * them. Each node and arc keeps its lemon handle to address the timing maps.
+ */
+class csr_graph {
+public:
+    using index = std::uint32_t;
+
+private:
+    std::vector< graph::node > m_nodes;
+    std::vector< index > m_node_index;
+    std::vector< edges > m_node_edges;
+    std::vector< entity_system::entity > m_pins;
+
+    std::vector< index > m_in_offsets;
+    std::vector< index > m_in_arcs;
+    std::vector< index > m_out_offsets;
+
+    std::vector< graph::edge > m_arcs;
+    std::vector< index > m_sources;
+    std::vector< index > m_targets;
+    std::vector< edge_types > m_arc_types;
+    std::vector< entity_system::entity > m_arc_entities;
+
+public:
+    csr_graph();
+    csr_graph(const graph & g, const std::vector< graph::node > & order);
+
+    std::size_t node_count() const {
+        return m_nodes.size();
+    }
+    std::size_t arc_count() const {
+        return m_arcs.size();
+    }
+
+    graph::node node(index u) const {
+        return m_nodes[u];
+    }
+    index node_index(graph::node u) const {
+        return m_node_index[lemon::ListDigraph::id(u)];
+    }
+    edges node_edge(index u) const {
+        return m_node_edges[u];
+    }
+    entity_system::entity pin(index u) const {
+        return m_pins[u];
+    }
+
+    std::size_t in_degree(index u) const {
+        return m_in_offsets[u+1] - m_in_offsets[u];
+    }
+    const index * in_arcs_begin(index u) const {
+        return m_in_arcs.data() + m_in_offsets[u];
+    }
+    const index * in_arcs_end(index u) const {
+        return m_in_arcs.data() + m_in_offsets[u+1];
+    }
+
+    std::size_t out_degree(index u) const {
+        return m_out_offsets[u+1] - m_out_offsets[u];
+    }
+    index out_arcs_begin(index u) const {
+        return m_out_offsets[u];
+    }
+    index out_arcs_end(index u) const {
+        return m_out_offsets[u+1];
+    }
+
+    graph::edge arc(index a) const {
+        return m_arcs[a];
+    }
+    index source(index a) const {
+        return m_sources[a];
+    }
+    index target(index a) const {
+        return m_targets[a];
+    }
+    edge_types arc_type(index a) const {
+        return m_arc_types[a];
+    }
+    entity_system::entity arc_entity(index a) const {
+        return m_arc_entities[a];
+    }
+};
+
+}
+}
+
+#endif // OPHIDIAN_TIMING_CSR_GRAPH_H
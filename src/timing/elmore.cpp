@@ -92,19 +92,18 @@ void packed_elmore::run()
 {
     assert(m_tree);
 
-    std::vector<boost::units::quantity< boost::units::si::capacitance > > downstream(m_tree->node_count());
-    for(std::size_t i = 0; i < m_tree->node_count(); ++i)
-        downstream[i] = m_tree->capacitance(i);
-
-    for(std::size_t i = 0; i < m_tree->node_count()-1; ++i)
-    {
-        std::size_t n = m_tree->node_count()-(i+1);
-        downstream[ m_tree->pred(n) ] += downstream[n];
-    }
+    const std::size_t node_count = m_tree->node_count();
+    const std::size_t * pred = m_tree->preds();
+    const double * resistance = m_tree->resistances();
+    const double * capacitance = m_tree->capacitances();
+
+    m_downstream.assign(capacitance, capacitance + node_count);
+    for(std::size_t n = node_count-1; n > 0; --n)
+        m_downstream[ pred[n] ] += m_downstream[n];
 
     m_delays[0] = boost::units::quantity< boost::units::si::time >(0.0*boost::units::si::seconds);
-    for(std::size_t i = 1; i < m_tree->node_count(); ++i)
-        m_delays[i] = m_delays[ m_tree->pred(i) ] + m_tree->resistance(i) * downstream.at(i);
+    for(std::size_t i = 1; i < node_count; ++i)
+        m_delays[i] = boost::units::quantity< boost::units::si::time >::from_value(m_delays[ pred[i] ].value() + resistance[i] * m_downstream[i]);
 }
 
 } /* namespace timing */
@@ -55,6 +55,7 @@ public:
 class packed_elmore {
     const interconnection::packed_rc_tree * m_tree;
     std::vector<boost::units::quantity< boost::units::si::time > > m_delays;
+    std::vector<double> m_downstream; // farads, kept between runs
 public:
     packed_elmore();
     virtual ~packed_elmore();
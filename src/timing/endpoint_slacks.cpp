@@ -0,0 +1,87 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#include "endpoint_slacks.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ophidian {
+namespace timing {
+
+void endpoint_slacks::replay(std::size_t node)
+{
+    m_worst[node] = std::min(m_worst[2*node], m_worst[2*node+1]);
+    m_negative[node] = m_negative[2*node] + m_negative[2*node+1];
+}
+
+endpoint_slacks::endpoint_slacks()
+{
+
+}
+
+endpoint_slacks::~endpoint_slacks()
+{
+
+}
+
+void endpoint_slacks::assign(const std::vector<TimeType> &slacks)
+{
+    const std::size_t n = slacks.size();
+    m_worst.resize(2*n);
+    m_negative.resize(2*n);
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        m_worst[n+i] = slacks[i];
+        m_negative[n+i] = std::min(slacks[i], TimeType());
+    }
+    for(std::size_t node = n; node > 1; --node)
+        replay(node-1);
+}
+
+void endpoint_slacks::update(std::size_t endpoint, TimeType slack)
+{
+    std::size_t node = size()+endpoint;
+    if(m_worst[node] == slack)
+        return;
+    m_worst[node] = slack;
+    m_negative[node] = std::min(slack, TimeType());
+    for(node /= 2; node >= 1; node /= 2)
+        replay(node);
+}
+
+std::vector<std::size_t> endpoint_slacks::histogram(TimeType lower, TimeType upper, std::size_t bins) const
+{
+    std::vector<std::size_t> counts(bins, 0);
+    if(bins == 0)
+        return counts;
+    const double scale = bins / (upper - lower).value();
+    for(std::size_t i = size(); i < m_worst.size(); ++i)
+    {
+        const double position = std::floor((m_worst[i] - lower).value() * scale);
+        if(std::isnan(position))
+            continue;
+        counts[static_cast<std::size_t>(std::max(0.0, std::min(position, static_cast<double>(bins-1))))]++;
+    }
+    return counts;
+}
+
+}
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#ifndef OPHIDIAN_TIMING_ENDPOINT_SLACKS_H
+#define OPHIDIAN_TIMING_ENDPOINT_SLACKS_H
+
+#include <vector>
+#include <boost/units/systems/si.hpp>
+#include <boost/units/limits.hpp>
+
+namespace ophidian {
+namespace timing {
+
+/// Slack of each endpoint, with the worst and the total negative slack kept up to date.
+/**
+ * A tournament tree over the endpoints stores, in each node, the worst slack and
+ * the sum of the negative slacks below it. Changing the slack of an endpoint only
+ * replays the matches on its way to the root, so WNS and TNS are read from the
+ * root in O(1) after O(log n) updates. The sums are recomputed from the children
+ * on every update, so they do not drift from a full recomputation.
+ **/
+class endpoint_slacks
+{
+public:
+    using TimeType = boost::units::quantity< boost::units::si::time >;
+private:
+    std::vector<TimeType> m_worst; // tree nodes, the leaves are in [size, 2*size)
+    std::vector<TimeType> m_negative;
+
+    void replay(std::size_t node);
+public:
+    endpoint_slacks();
+    virtual ~endpoint_slacks();
+
+    // rebuilds the tree from the slack of every endpoint
+    void assign(const std::vector<TimeType> & slacks);
+    void update(std::size_t endpoint, TimeType slack);
+
+    std::size_t size() const {
+        return m_worst.size()/2;
+    }
+    TimeType slack(std::size_t endpoint) const {
+        return m_worst[size()+endpoint];
+    }
+    // max() when there are no endpoints
+    TimeType worst() const {
+        return m_worst.empty() ? std::numeric_limits<TimeType>::max() : m_worst[1 % m_worst.size()];
+    }
+    TimeType total_negative() const {
+        return m_negative.empty() ? TimeType() : m_negative[1 % m_negative.size()];
+    }
+
+    // number of endpoints by slack in bins equal parts of [lower, upper);
+    // slacks out of the range are counted in the first and the last bins
+    std::vector<std::size_t> histogram(TimeType lower, TimeType upper, std::size_t bins) const;
+};
+
+}
+}
+
+#endif // OPHIDIAN_TIMING_ENDPOINT_SLACKS_H
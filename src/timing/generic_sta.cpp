@@ -20,44 +20,59 @@ under the License.
 
 #include "generic_sta.h"
 
+#include <algorithm>
+#include <array>
+
 namespace ophidian {
 namespace timing {
 
-void test_calculator:: compute_tests()
+void test_calculator::compute_test(std::size_t i)
 {
-    auto tests = topology.g.tests();
-    std::size_t i;
+    const test & t = topology.g.tests()[i];
+    auto pin_ck = topology.g.pin(t.ck);
     using DelayType = boost::units::quantity< boost::units::si::time >;
-    for(i = 0; i < tests.size(); ++i) // parallel
+    DelayType setup, hold;
+    switch(topology.g.node_edge(t.d))
     {
-        const test & t = tests[i];
-        auto pin_ck = topology.g.pin(t.ck);
-        auto pin_d = topology.g.pin(t.d);
-        DelayType setup, hold;
-        switch(topology.g.node_edge(t.d))
-        {
-        case edges::RISE:
-            setup = late.lib.setup_rise(t.tarc).compute(early.nodes.slew(t.ck), late.nodes.slew(t.d));
-            hold = early.lib.hold_rise(t.tarc).compute(late.nodes.slew(t.ck), early.nodes.slew(t.d));
-            break;
-        case edges::FALL:
-            setup = late.lib.setup_fall(t.tarc).compute(early.nodes.slew(t.ck), late.nodes.slew(t.d));
-            hold = early.lib.hold_fall(t.tarc).compute(late.nodes.slew(t.ck), early.nodes.slew(t.d));
-            break;
-        }
-        const DelayType e_ck = early.nodes.arrival(topology.g.rise_node(pin_ck));
-        const DelayType l_ck = late.nodes.arrival(topology.g.rise_node(pin_ck));
-        late.nodes.required(t.d, e_ck-setup+clock_period);
-        early.nodes.required(t.d, l_ck+hold);
-
+    case edges::RISE:
+        setup = late.lib.setup_rise(t.tarc).compute(early.nodes.slew(t.ck), late.nodes.slew(t.d));
+        hold = early.lib.hold_rise(t.tarc).compute(late.nodes.slew(t.ck), early.nodes.slew(t.d));
+        break;
+    case edges::FALL:
+        setup = late.lib.setup_fall(t.tarc).compute(early.nodes.slew(t.ck), late.nodes.slew(t.d));
+        hold = early.lib.hold_fall(t.tarc).compute(late.nodes.slew(t.ck), early.nodes.slew(t.d));
+        break;
     }
+    const DelayType e_ck = early.nodes.arrival(topology.g.rise_node(pin_ck));
+    const DelayType l_ck = late.nodes.arrival(topology.g.rise_node(pin_ck));
+    late.nodes.required(t.d, e_ck-setup+clock_period);
+    early.nodes.required(t.d, l_ck+hold);
+}
+
+void test_calculator:: compute_tests()
+{
+    // each test writes the required times of its own data node
+    const std::size_t test_count = topology.g.tests().size();
+    std::size_t i;
+#pragma omp parallel for schedule(dynamic, 64)
+    for(i = 0; i < test_count; ++i)
+        compute_test(i);
+}
+
+void test_calculator::compute_tests(const std::vector<std::size_t> & tests)
+{
+    std::size_t i;
+#pragma omp parallel for schedule(dynamic, 64) if(tests.size() > 64)
+    for(i = 0; i < tests.size(); ++i)
+        compute_test(tests[i]);
 }
 
 graph_and_topology::graph_and_topology(const graph &G, const netlist::netlist &netlist, const library &lib):
     g(G),
     netlist(netlist),
     sorted(g.nodes_count()),
-    sorted_drivers(g.nodes_count()){
+    sorted_drivers(g.nodes_count()),
+    net_drivers(netlist.net_system().size()){
 
     using GraphType = lemon::ListDigraph;
 
@@ -65,8 +80,6 @@ graph_and_topology::graph_and_topology(const graph &G, const netlist::netlist &n
     lemon::topologicalSort(g.G(), order);
 
 
-    std::vector<GraphType::Node> sorted_nodes(g.nodes_count());
-
     GraphType::NodeMap<int> level(g.G());
 
     for(GraphType::NodeIt it(g.G()); it != lemon::INVALID; ++it)
@@ -91,19 +104,36 @@ graph_and_topology::graph_and_topology(const graph &G, const netlist::netlist &n
         }
     }
 
+    std::vector<GraphType::Node> by_level(sorted);
+    std::stable_sort(by_level.begin(), by_level.end(), [&level](GraphType::Node a, GraphType::Node b)->bool {
+        return level[a] < level[b];
+    });
+    csr = csr_graph(g, by_level);
+
     levels.resize(num_levels+1);
 
-    for(auto node : sorted)
+    for(std::size_t i = 0; i < csr.node_count(); ++i)
     {
-        if(lib.pin_direction(netlist.pin_std_cell(g.pin(node))) == standard_cell::pin_directions::OUTPUT)
-            levels[level[node]].push_back(node);
+        if(lib.pin_direction(netlist.pin_std_cell(csr.pin(i))) == standard_cell::pin_directions::OUTPUT)
+            levels[level[csr.node(i)]].push_back(static_cast<csr_graph::index>(i));
     }
 
-    auto beg = std::remove_if(levels.begin(), levels.end(), [this](std::vector<lemon::ListDigraph::Node> & vec)->bool{
+    auto beg = std::remove_if(levels.begin(), levels.end(), [this](std::vector<csr_graph::index> & vec)->bool{
             return vec.empty();
 });
     levels.erase(beg, levels.end());
 
+    driver_level.assign(csr.node_count(), -1);
+    for(std::size_t l = 0; l < levels.size(); ++l)
+    {
+        for(auto node : levels[l])
+        {
+            driver_level[node] = static_cast<int>(l);
+            if(csr.in_degree(node) > 0)
+                net_drivers[netlist.net_system().lookup(netlist.pin_net(csr.pin(node)))].push_back(node);
+        }
+    }
+
 
     auto begin = std::remove_if(
                 sorted_drivers.begin(),
@@ -113,11 +143,56 @@ graph_and_topology::graph_and_topology(const graph &G, const netlist::netlist &n
 });
 
     sorted_drivers.erase(begin, sorted_drivers.end());
+
+    // the sinks of each driver are updated with it by the backward pass, so
+    // they must belong to a single driver and only feed drivers of higher levels
+    std::vector<char> leveled(csr.node_count(), 0);
+    for(auto & level : levels)
+    {
+        for(auto node : level)
+        {
+            leveled[node] = 1;
+            for(auto a = csr.out_arcs_begin(node); a != csr.out_arcs_end(node); ++a)
+            {
+                const csr_graph::index sink = csr.target(a);
+                if(driver_level[sink] != -1)
+                    continue;
+                assert(!leveled[sink]);
+                leveled[sink] = 1;
+#ifndef NDEBUG
+                for(auto cell_arc = csr.out_arcs_begin(sink); cell_arc != csr.out_arcs_end(sink); ++cell_arc)
+                    assert(driver_level[csr.target(cell_arc)] > driver_level[node]);
+#endif
+            }
+        }
+    }
+    for(std::size_t i = csr.node_count(); i > 0; --i)
+    {
+        const csr_graph::index node = static_cast<csr_graph::index>(i-1);
+        if(!leveled[node] && csr.out_degree(node) > 0)
+            unleveled.push_back(node);
+    }
+
+    // the tests to recompute when the timing of a node changes
+    const std::vector<test> & tests = g.tests();
+    auto test_nodes = [this, &tests](std::size_t i) -> std::array<csr_graph::index, 3> {
+        return {{csr.node_index(tests[i].ck), csr.node_index(g.rise_node(g.pin(tests[i].ck))), csr.node_index(tests[i].d)}};
+    };
+    node_tests_begin.assign(csr.node_count()+1, 0);
+    for(std::size_t i = 0; i < tests.size(); ++i)
+        for(auto node : test_nodes(i))
+            ++node_tests_begin[node+1];
+    std::partial_sum(node_tests_begin.begin(), node_tests_begin.end(), node_tests_begin.begin());
+    node_tests.resize(node_tests_begin.back());
+    std::vector<std::size_t> next(node_tests_begin.begin(), node_tests_begin.end()-1);
+    for(std::size_t i = 0; i < tests.size(); ++i)
+        for(auto node : test_nodes(i))
+            node_tests[next[node]++] = i;
 #ifndef NDEBUG
     std::for_each(sorted_drivers.begin(), sorted_drivers.end(), [this, lib, netlist](GraphType::Node node){
         assert(lib.pin_direction(netlist.pin_std_cell(g.pin(node))) == standard_cell::pin_directions::OUTPUT);
     });
-    std::for_each(levels.begin(), levels.end(), [this](std::vector<lemon::ListDigraph::Node> & vec)->bool{
+    std::for_each(levels.begin(), levels.end(), [this](std::vector<csr_graph::index> & vec){
         assert(!vec.empty());
     });
 #endif
@@ -20,6 +20,7 @@ under the License.
 
 #include "../timing/library.h"
 #include "../timing/graph.h"
+#include "../timing/csr_graph.h"
 #include "../netlist/netlist.h"
 #include "../interconnection/rc_tree.h"
 
@@ -28,6 +29,8 @@ under the License.
 #include <boost/units/limits.hpp>
 #include <boost/units/cmath.hpp>
 #include <functional>
+#include <numeric>
+#include <queue>
 
 #include "ceff.h"
 #include "design_constraints.h"
@@ -103,12 +106,26 @@ struct timing_data {
 };
 
 
+// arrivals and slacks of a pin, as returned by the bulk queries
+struct pin_timing {
+    boost::units::quantity< boost::units::si::time > rise_arrival;
+    boost::units::quantity< boost::units::si::time > fall_arrival;
+    boost::units::quantity< boost::units::si::time > rise_slack;
+    boost::units::quantity< boost::units::si::time > fall_slack;
+};
+
 struct graph_and_topology {
     const graph & g;
     const netlist::netlist & netlist;
     std::vector<lemon::ListDigraph::Node> sorted;
-    std::vector< std::vector<lemon::ListDigraph::Node> > levels;
+    csr_graph csr; // nodes sorted by level, so csr indices are topological positions
+    std::vector< std::vector<csr_graph::index> > levels; // drivers of each level
     std::vector<lemon::ListDigraph::Node> sorted_drivers;
+    std::vector<int> driver_level; // index in levels by csr index, -1 for nodes out of levels
+    std::vector< std::vector<csr_graph::index> > net_drivers; // driver nodes with fanin, by net index
+    std::vector<csr_graph::index> unleveled; // nodes with fanout that are neither drivers nor their sinks, in reverse topological order
+    std::vector<std::size_t> node_tests_begin; // node_tests[node_tests_begin[node], node_tests_begin[node+1]) by csr index
+    std::vector<std::size_t> node_tests; // tests reading the slew or arrival of a node: its CK, the rise node of its CK pin and its D
     graph_and_topology(const graph & G, const netlist::netlist & netlist, const library & lib);
 
 };
@@ -122,7 +139,9 @@ struct test_calculator {
     boost::units::quantity< boost::units::si::time > clock_period;
 
     void compute_tests();
-
+    // recomputes only the given tests
+    void compute_tests(const std::vector<std::size_t> & tests);
+    void compute_test(std::size_t i);
 
 };
 
@@ -134,45 +153,206 @@ class generic_sta
 
 
 
-    timing_data & m_timing;
+    std::vector<timing_data*> m_corners;
     graph_and_topology * m_topology;
     const entity_system::vector_property< interconnection::packed_rc_tree > & m_rc_trees;
     MergeStrategy m_merge;
-
-    SlewType compute_slew(lemon::ListDigraph::Node node, CapacitanceType load) const {
+    bool m_parallel;
+
+    // incremental state: drivers recomputed by the last incremental_update_ats(),
+    // requireds of the tests seen by the last backward propagation (corner major),
+    // queue marks (all clear between calls), drivers pending per level and one
+    // wire delay workspace per thread and corner, kept across calls
+    std::vector<csr_graph::index> m_updated_drivers;
+    std::vector<csr_graph::index> m_updated_sinks;
+    std::vector<SlewType> m_test_requireds;
+    std::vector<char> m_queued;
+    std::vector< std::vector<csr_graph::index> > m_pending;
+    std::vector< std::vector<wire_delay_workspace> > m_workspaces;
+    std::size_t m_largest_rc_tree;
+
+    SlewType compute_slew(const timing_data & timing, csr_graph::index node, CapacitanceType load) const {
+        const csr_graph & G = m_topology->csr;
         SlewType worst_slew = MergeStrategy::best();
-        if(lemon::countInArcs(m_topology->g.G(), node) == 0) // PI without driver
-            return m_timing.nodes.slew(node);
-        switch(m_topology->g.node_edge(node))
+        if(G.in_degree(node) == 0) // PI without driver
+            return timing.nodes.slew(G.node(node));
+        switch(G.node_edge(node))
         {
         case edges::RISE:
-            for(lemon::ListDigraph::InArcIt it(m_topology->g.G(), node); it != lemon::INVALID; ++it)
+            for(auto it = G.in_arcs_begin(node); it != G.in_arcs_end(node); ++it)
             {
-                auto tarc = m_topology->g.edge_entity(it) ;
-                worst_slew = m_merge(worst_slew, m_timing.lib.timing_arc_rise_slew(tarc).compute(load, m_timing.nodes.slew(m_topology->g.edge_source(it))));
+                auto tarc = G.arc_entity(*it);
+                worst_slew = m_merge(worst_slew, timing.lib.timing_arc_rise_slew(tarc).compute(load, timing.nodes.slew(G.node(G.source(*it)))));
             }
             break;
         case edges::FALL:
-            for(lemon::ListDigraph::InArcIt it(m_topology->g.G(), node); it != lemon::INVALID; ++it)
+            for(auto it = G.in_arcs_begin(node); it != G.in_arcs_end(node); ++it)
             {
-                auto tarc = m_topology->g.edge_entity(it) ;
-                worst_slew = m_merge(worst_slew, m_timing.lib.timing_arc_fall_slew(tarc).compute(load, m_timing.nodes.slew(m_topology->g.edge_source(it))));
+                auto tarc = G.arc_entity(*it);
+                worst_slew = m_merge(worst_slew, timing.lib.timing_arc_fall_slew(tarc).compute(load, timing.nodes.slew(G.node(G.source(*it)))));
             }
             break;
         }
         return worst_slew;
     }
 
+    // simulates the net of the driver and computes its cell arcs for one corner,
+    // leaving the wire slews and delays of the net in the workspace
+    void update_corner(csr_graph::index node, const interconnection::packed_rc_tree & tree, timing_data & timing, wire_delay_workspace & workspace) {
+        const csr_graph & G = m_topology->csr;
+        const auto driver = G.node(node);
+
+        WireDelayModel calculator;
+        workspace.attach(calculator, tree);
+        auto s_calculator = [this, &timing, node](CapacitanceType load) -> SlewType {
+            return compute_slew(timing, node, load);
+        };
+
+        CapacitanceType load = calculator.simulate(s_calculator, tree);
+
+        timing.nodes.load(driver, load);
+        timing.nodes.slew(driver, workspace.slews[0]);
+
+        SlewType worst_arrival = MergeStrategy::best();
+        switch(G.node_edge(node))
+        {
+        case edges::RISE:
+            for(auto it = G.in_arcs_begin(node); it != G.in_arcs_end(node); ++it)
+            {
+                auto tarc = G.arc_entity(*it);
+                auto edge_source = G.node(G.source(*it));
+                auto arc_delay = timing.lib.timing_arc_rise_delay(tarc).compute(load, timing.nodes.slew(edge_source));
+                auto arc_slew = timing.lib.timing_arc_rise_slew(tarc).compute(load, timing.nodes.slew(edge_source));
+                timing.arcs.delay(G.arc(*it), arc_delay);
+                timing.arcs.slew(G.arc(*it), arc_slew);
+                worst_arrival = m_merge(worst_arrival, timing.nodes.arrival(edge_source) + arc_delay);
+            }
+            break;
+        case edges::FALL:
+            for(auto it = G.in_arcs_begin(node); it != G.in_arcs_end(node); ++it)
+            {
+                auto tarc = G.arc_entity(*it);
+                auto edge_source = G.node(G.source(*it));
+                auto arc_delay = timing.lib.timing_arc_fall_delay(tarc).compute(load, timing.nodes.slew(edge_source));
+                auto arc_slew = timing.lib.timing_arc_fall_slew(tarc).compute(load, timing.nodes.slew(edge_source));
+                timing.arcs.delay(G.arc(*it), arc_delay);
+                timing.arcs.slew(G.arc(*it), arc_slew);
+                worst_arrival = m_merge(worst_arrival, timing.nodes.arrival(edge_source) + arc_delay);
+            }
+            break;
+        }
+        timing.nodes.arrival(driver, worst_arrival);
+    }
+
+    // Updates the driver in every corner. The net, its rc tree and the tap of
+    // each sink are resolved once and shared by all corners; workspaces holds
+    // one workspace per corner.
+    // returns true when the arrival or the slew of any sink of the net changed
+    bool update_driver(csr_graph::index node, std::vector<wire_delay_workspace> & workspaces) {
+        const csr_graph & G = m_topology->csr;
+        const auto driver = G.node(node);
+        auto pin = G.pin(node);
+        auto net = m_topology->netlist.pin_net(pin);
+        auto & tree = m_rc_trees[m_topology->netlist.net_system().lookup(net)];
+
+        for(std::size_t c = 0; c < m_corners.size(); ++c)
+            update_corner(node, tree, *m_corners[c], workspaces[c]);
+
+        bool changed = false;
+        for(auto a = G.out_arcs_begin(node); a != G.out_arcs_end(node); ++a)
+        {
+            auto arc = G.arc(a);
+            auto arc_target = G.node(G.target(a));
+            auto target_pin = G.pin(G.target(a));
+            auto target_capacitor = tree.has_pin_taps() ? tree.tap(target_pin) : tree.tap(m_topology->netlist.pin_name(target_pin));
+            for(std::size_t c = 0; c < m_corners.size(); ++c)
+            {
+                timing_data & timing = *m_corners[c];
+                const SlewType slew = workspaces[c].slews[target_capacitor];
+                const SlewType delay = workspaces[c].delays[target_capacitor];
+                timing.arcs.slew(arc, slew);
+                timing.arcs.delay(arc, delay);
+                const SlewType target_arrival = timing.nodes.arrival(driver) + delay;
+                changed = changed || timing.nodes.slew(arc_target) != slew || timing.nodes.arrival(arc_target) != target_arrival;
+                timing.nodes.slew(arc_target, slew);
+                timing.nodes.arrival(arc_target, target_arrival);
+            }
+        }
+        return changed;
+    }
+
+    std::size_t largest_rc_tree() const {
+        std::size_t largest = 0;
+        for(auto & tree : m_rc_trees)
+            largest = std::max(largest, tree.node_count());
+        return largest;
+    }
+
+    // one workspace per corner for each thread a parallel region may use;
+    // workspaces grow by themselves when they get a larger tree
+    void reserve_workspaces() {
+        const std::size_t threads = static_cast<std::size_t>(omp_get_max_threads());
+        if(m_workspaces.size() < threads)
+            m_workspaces.resize(threads, std::vector<wire_delay_workspace>(m_corners.size(), wire_delay_workspace(m_largest_rc_tree)));
+    }
+
+    // returns true when the required time of any corner changed
+    bool update_required(csr_graph::index node) {
+        const csr_graph & G = m_topology->csr;
+        bool changed = false;
+        for(auto timing : m_corners)
+        {
+            SlewType required = MergeStrategy::worst();
+            for(auto a = G.out_arcs_begin(node); a != G.out_arcs_end(node); ++a)
+                required = m_merge.inverted(required, timing->nodes.required(G.node(G.target(a)))-timing->arcs.delay(G.arc(a)));
+            changed = changed || timing->nodes.required(G.node(node)) != required;
+            timing->nodes.required(G.node(node), required);
+        }
+        return changed;
+    }
+
+    void store_test_requireds() {
+        const std::vector<test> & tests = m_topology->g.tests();
+        m_test_requireds.resize(tests.size()*m_corners.size());
+        for(std::size_t c = 0; c < m_corners.size(); ++c)
+            for(std::size_t i = 0; i < tests.size(); ++i)
+                m_test_requireds[c*tests.size()+i] = m_corners[c]->nodes.required(tests[i].d);
+    }
+
+    void store_test_requireds(const std::vector<std::size_t> & indices) {
+        const std::vector<test> & tests = m_topology->g.tests();
+        for(std::size_t c = 0; c < m_corners.size(); ++c)
+            for(auto i : indices)
+                m_test_requireds[c*tests.size()+i] = m_corners[c]->nodes.required(tests[i].d);
+    }
+
+    bool test_required_changed(std::size_t i) const {
+        const std::vector<test> & tests = m_topology->g.tests();
+        for(std::size_t c = 0; c < m_corners.size(); ++c)
+        {
+            if(m_corners[c]->nodes.required(tests[i].d) != m_test_requireds[c*tests.size()+i])
+                return true;
+        }
+        return false;
+    }
+
 public:
     generic_sta( timing_data & timing, graph_and_topology & topology, const entity_system::vector_property< interconnection::packed_rc_tree > & rc_trees) :
-        m_timing(timing),
-        m_topology(&topology),
-        m_rc_trees(rc_trees)
+        generic_sta(std::vector<timing_data*>{&timing}, topology, rc_trees)
     {
 
+    }
 
-
-
+    // one timing data per corner, all of them propagated by the same traversal
+    generic_sta( const std::vector<timing_data*> & corners, graph_and_topology & topology, const entity_system::vector_property< interconnection::packed_rc_tree > & rc_trees) :
+        m_corners(corners),
+        m_topology(&topology),
+        m_rc_trees(rc_trees),
+        m_parallel(true),
+        m_largest_rc_tree(largest_rc_tree())
+    {
+        assert(!m_corners.empty());
+        reserve_workspaces();
     }
 
 
@@ -181,171 +361,315 @@ public:
         m_topology = &topology;
     }
 
+    std::size_t corner_count() const {
+        return m_corners.size();
+    }
+
 
 
-    void set_constraints(const design_constraints & dc)
+    void set_constraints(const design_constraints & dc, std::size_t corner = 0)
     {
 
         using namespace boost::units;
         using namespace boost::units::si;
 
-        m_timing.nodes.arrival( m_topology->g.rise_node(m_topology->netlist.pin_by_name(dc.clock.port_name)), 0.0*seconds );
-        m_timing.nodes.arrival( m_topology->g.fall_node(m_topology->netlist.pin_by_name(dc.clock.port_name)), 0.0*seconds );
+        timing_data & timing = *m_corners.at(corner);
+
+        timing.nodes.arrival( m_topology->g.rise_node(m_topology->netlist.pin_by_name(dc.clock.port_name)), 0.0*seconds );
+        timing.nodes.arrival( m_topology->g.fall_node(m_topology->netlist.pin_by_name(dc.clock.port_name)), 0.0*seconds );
 
         for(auto & i : dc.input_delays)
         {
             auto pin = m_topology->netlist.pin_by_name(i.port_name);
-            m_timing.nodes.arrival( m_topology->g.rise_node(pin), quantity<si::time>(i.delay*pico*seconds) );
-            m_timing.nodes.arrival( m_topology->g.fall_node(pin), quantity<si::time>(i.delay*pico*seconds) );
+            timing.nodes.arrival( m_topology->g.rise_node(pin), quantity<si::time>(i.delay*pico*seconds) );
+            timing.nodes.arrival( m_topology->g.fall_node(pin), quantity<si::time>(i.delay*pico*seconds) );
         }
 
         for(auto & i : dc.input_drivers)
         {
             auto pin = m_topology->netlist.pin_by_name(i.port_name);
-            m_timing.nodes.slew( m_topology->g.rise_node(pin), quantity<si::time>(i.slew_rise*pico*seconds) );
-            m_timing.nodes.slew( m_topology->g.fall_node(pin), quantity<si::time>(i.slew_fall*pico*seconds) );
+            timing.nodes.slew( m_topology->g.rise_node(pin), quantity<si::time>(i.slew_rise*pico*seconds) );
+            timing.nodes.slew( m_topology->g.fall_node(pin), quantity<si::time>(i.slew_fall*pico*seconds) );
         }
 
 
         for(lemon::ListDigraph::NodeIt node(m_topology->g.G()); node != lemon::INVALID; ++node)
         {
-            if(m_timing.lib.pin_clock_input(m_topology->netlist.pin_std_cell(m_topology->g.pin(node))))
-                m_timing.nodes.required( node, MergeStrategy::worst() );
+            if(timing.lib.pin_clock_input(m_topology->netlist.pin_std_cell(m_topology->g.pin(node))))
+                timing.nodes.required( node, MergeStrategy::worst() );
             else if(lemon::countOutArcs(m_topology->g.G(), node) == 0 )
-                m_timing.nodes.required( node, m_merge(quantity<si::time>(0.0*seconds), quantity<si::time>(dc.clock.period * pico* seconds)) );
+                timing.nodes.required( node, m_merge(quantity<si::time>(0.0*seconds), quantity<si::time>(dc.clock.period * pico* seconds)) );
         }
 
     }
 
 
-    SlewType rise_arrival(const entity_system::entity pin) const
+    SlewType rise_arrival(const entity_system::entity pin, std::size_t corner = 0) const
     {
-        return m_timing.nodes.arrival(m_topology->g.rise_node(pin));
+        return m_corners[corner]->nodes.arrival(m_topology->g.rise_node(pin));
     }
-    SlewType fall_arrival(const entity_system::entity pin) const
+    SlewType fall_arrival(const entity_system::entity pin, std::size_t corner = 0) const
     {
-        return m_timing.nodes.arrival(m_topology->g.fall_node(pin));
+        return m_corners[corner]->nodes.arrival(m_topology->g.fall_node(pin));
     }
 
-    SlewType rise_slew(const entity_system::entity pin) const
+    SlewType rise_slew(const entity_system::entity pin, std::size_t corner = 0) const
     {
-        return m_timing.nodes.slew(m_topology->g.rise_node(pin));
+        return m_corners[corner]->nodes.slew(m_topology->g.rise_node(pin));
     }
-    SlewType fall_slew(const entity_system::entity pin) const
+    SlewType fall_slew(const entity_system::entity pin, std::size_t corner = 0) const
     {
-        return m_timing.nodes.slew(m_topology->g.fall_node(pin));
+        return m_corners[corner]->nodes.slew(m_topology->g.fall_node(pin));
     }
 
-    SlewType rise_slack(const entity_system::entity pin) const
+    SlewType rise_slack(const entity_system::entity pin, std::size_t corner = 0) const
     {
         auto node = m_topology->g.rise_node(pin);
-        return MergeStrategy::slack_signal()*(m_timing.nodes.required(node)-m_timing.nodes.arrival(node));
+        return MergeStrategy::slack_signal()*(m_corners[corner]->nodes.required(node)-m_corners[corner]->nodes.arrival(node));
     }
-    SlewType fall_slack(const entity_system::entity pin) const
+    SlewType fall_slack(const entity_system::entity pin, std::size_t corner = 0) const
     {
         auto node = m_topology->g.fall_node(pin);
-        return MergeStrategy::slack_signal()*(m_timing.nodes.required(node)-m_timing.nodes.arrival(node));
+        return MergeStrategy::slack_signal()*(m_corners[corner]->nodes.required(node)-m_corners[corner]->nodes.arrival(node));
     }
 
+    // timing of every pin, in the order of pins; throws std::out_of_range if a pin is not in the graph
+    void pins_timing(const std::vector<entity_system::entity> & pins, std::vector<pin_timing> & timing, std::size_t corner = 0) const
+    {
+        const graph & g = m_topology->g;
+        const graph_nodes_timing & nodes = m_corners[corner]->nodes;
+        // resolve the nodes before the parallel region, an exception must not escape it
+        std::vector< std::pair<graph::node, graph::node> > pin_nodes(pins.size());
+        for(std::size_t i = 0; i < pins.size(); ++i)
+            pin_nodes[i] = std::make_pair(g.rise_node(pins[i]), g.fall_node(pins[i]));
+        timing.resize(pins.size());
+        std::size_t i;
+#pragma omp parallel for if(m_parallel && pins.size() > 1024)
+        for(i = 0; i < pins.size(); ++i)
+        {
+            const auto rise = pin_nodes[i].first;
+            const auto fall = pin_nodes[i].second;
+            timing[i].rise_arrival = nodes.arrival(rise);
+            timing[i].fall_arrival = nodes.arrival(fall);
+            timing[i].rise_slack = MergeStrategy::slack_signal()*(nodes.required(rise)-nodes.arrival(rise));
+            timing[i].fall_slack = MergeStrategy::slack_signal()*(nodes.required(fall)-nodes.arrival(fall));
+        }
+    }
+
+    void parallel(bool enabled) {
+        m_parallel = enabled;
+    }
+
+    bool parallel() const {
+        return m_parallel;
+    }
+
+    // Drivers of the same level only read values of lower levels and each one
+    // writes its own node, its cell arcs and the sinks of its own net, so a
+    // level can be processed by many threads with no synchronization other
+    // than the barrier between levels. Results do not depend on thread count.
     void update_ats() {
+        const csr_graph & G = m_topology->csr;
+        const std::vector< std::vector<csr_graph::index> > & levels = m_topology->levels;
+        m_largest_rc_tree = largest_rc_tree();
+        reserve_workspaces();
+#pragma omp parallel if(m_parallel)
         {
-            for(auto & level : m_topology->levels)
+            std::vector<wire_delay_workspace> & workspaces = m_workspaces[omp_get_thread_num()];
+            for(std::size_t l = 0; l < levels.size(); ++l)
             {
+                const std::vector<csr_graph::index> & level = levels[l];
                 std::size_t i;
-                for(i = 0; i < level.size(); ++i) // paralell
+#pragma omp for schedule(dynamic, 16)
+                for(i = 0; i < level.size(); ++i)
                 {
-                    auto node = level[i];
-                    if(lemon::countInArcs(m_topology->g.G(), node) != 0)
-                    {
-                        auto pin = m_topology->g.pin(node);
-                        auto net = m_topology->netlist.pin_net(pin);
-                        auto & tree = m_rc_trees[m_topology->netlist.net_system().lookup(net)];
-
-                        std::vector< SlewType > slews(tree.node_count());
-                        std::vector< SlewType > delays(tree.node_count());
-                        std::vector< CapacitanceType > ceffs(tree.node_count());
-                        WireDelayModel calculator;
-                        calculator.delay_map(delays);
-                        calculator.slew_map(slews);
-                        calculator.ceff_map(ceffs);
-                        std::function<SlewType(CapacitanceType)> s_calculator = std::bind(&generic_sta::compute_slew, this, node, std::placeholders::_1);
-
-                        CapacitanceType load = calculator.simulate(s_calculator, tree);
-
-                        m_timing.nodes.load(node, load);
-                        m_timing.nodes.slew(node, slews[0]);
-
-                        SlewType worst_arrival = MergeStrategy::best();
-                        switch(m_topology->g.node_edge(node))
-                        {
-                        case edges::RISE:
-                            for(lemon::ListDigraph::InArcIt it(m_topology->g.G(), node); it != lemon::INVALID; ++it)
-                            {
-                                auto tarc = m_topology->g.edge_entity(it) ;
-                                auto edge_source = m_topology->g.edge_source(it);
-                                auto arc_delay = m_timing.lib.timing_arc_rise_delay(tarc).compute(load, m_timing.nodes.slew(edge_source));
-                                auto arc_slew = m_timing.lib.timing_arc_rise_slew(tarc).compute(load, m_timing.nodes.slew(edge_source));
-                                m_timing.arcs.delay(it, arc_delay);
-                                m_timing.arcs.slew(it, arc_slew);
-                                worst_arrival = m_merge(worst_arrival, m_timing.nodes.arrival(edge_source) + arc_delay);
-                            }
-                            break;
-                        case edges::FALL:
-                            for(lemon::ListDigraph::InArcIt it(m_topology->g.G(), node); it != lemon::INVALID; ++it)
-                            {
-                                auto tarc = m_topology->g.edge_entity(it) ;
-                                auto edge_source = m_topology->g.edge_source(it);
-                                auto arc_delay = m_timing.lib.timing_arc_fall_delay(tarc).compute(load, m_timing.nodes.slew(edge_source));
-                                auto arc_slew = m_timing.lib.timing_arc_fall_slew(tarc).compute(load, m_timing.nodes.slew(edge_source));
-                                m_timing.arcs.delay(it, arc_delay);
-                                m_timing.arcs.slew(it, arc_slew);
-                                worst_arrival = m_merge(worst_arrival, m_timing.nodes.arrival(edge_source) + arc_delay);
-                            }
-                            break;
-                        }
-                        m_timing.nodes.arrival(node, worst_arrival);
-                        for(lemon::ListDigraph::OutArcIt arc(m_topology->g.G(), node); arc != lemon::INVALID; ++arc)
-                        {
-                            auto arc_target = m_topology->g.edge_target(arc);
-                            auto target_pin = m_topology->g.pin(arc_target);
-                            auto target_capacitor = tree.tap(m_topology->netlist.pin_name(target_pin));
-                            m_timing.arcs.slew(arc, slews[target_capacitor]);
-                            m_timing.arcs.delay(arc, delays[target_capacitor]);
-                            m_timing.nodes.slew(arc_target, m_timing.arcs.slew(arc));
-                            m_timing.nodes.arrival(arc_target, m_timing.nodes.arrival(node) + m_timing.arcs.delay(arc));
-                        }
-                    }
+                    if(G.in_degree(level[i]) != 0)
+                        update_driver(level[i], workspaces);
                 }
             }
+        }
+    }
 
+    // Recomputes only the drivers of the given nets and the drivers whose inputs
+    // changed because of them. Drivers are visited level by level and the
+    // propagation stops at the drivers whose sinks keep the same arrivals and
+    // slews in every corner, so the result is the same as a full update_ats().
+    // The cost depends on the drivers visited, not on the size of the design.
+    void incremental_update_ats(const std::vector<entity_system::entity> & nets) {
+        const csr_graph & G = m_topology->csr;
+        const std::vector< std::vector<csr_graph::index> > & levels = m_topology->levels;
+        if(m_queued.size() != G.node_count())
+            m_queued.assign(G.node_count(), 0);
+        m_pending.resize(levels.size());
+        m_updated_drivers.clear();
+
+        auto enqueue = [this](csr_graph::index node) {
+            if(!m_queued[node])
+            {
+                m_queued[node] = 1;
+                m_pending[m_topology->driver_level[node]].push_back(node);
+            }
+        };
+        for(auto net : nets)
+            for(auto node : m_topology->net_drivers[m_topology->netlist.net_system().lookup(net)])
+                enqueue(node);
+
+        reserve_workspaces();
+        std::vector<char> changed;
+        for(std::size_t l = 0; l < m_pending.size(); ++l)
+        {
+            std::vector<csr_graph::index> & level = m_pending[l];
+            if(level.empty())
+                continue;
+            changed.assign(level.size(), 0);
+#pragma omp parallel if(m_parallel && level.size() > 64)
+            {
+                std::vector<wire_delay_workspace> & thread_workspaces = m_workspaces[omp_get_thread_num()];
+                std::size_t i;
+#pragma omp for schedule(dynamic, 16)
+                for(i = 0; i < level.size(); ++i)
+                    changed[i] = update_driver(level[i], thread_workspaces);
+            }
+            for(std::size_t i = 0; i < level.size(); ++i)
+            {
+                m_updated_drivers.push_back(level[i]);
+                if(!changed[i])
+                    continue;
+                for(auto net_arc = G.out_arcs_begin(level[i]); net_arc != G.out_arcs_end(level[i]); ++net_arc)
+                {
+                    auto sink = G.target(net_arc);
+                    for(auto cell_arc = G.out_arcs_begin(sink); cell_arc != G.out_arcs_end(sink); ++cell_arc)
+                        enqueue(G.target(cell_arc));
+                }
+            }
+            level.clear();
         }
+        // every queued driver has been updated
+        for(auto node : m_updated_drivers)
+            m_queued[node] = 0;
     }
 
+    // Backward counterpart of update_ats(). Levels are visited from the last one
+    // and each driver first updates the sinks of its net, whose cell arcs only
+    // reach drivers of higher levels, and then itself. A sink belongs to a single
+    // net, so threads never write the same node. Fanouts that are drivers
+    // themselves (the input driver cells of the PIs) belong to higher levels. The remaining nodes do not feed
+    // any driver and are updated at the end in reverse topological order.
     void update_rts() {
-        for(auto node_it = m_topology->sorted.rbegin(); node_it != m_topology->sorted.rend(); ++node_it)
+        const csr_graph & G = m_topology->csr;
+        const std::vector< std::vector<csr_graph::index> > & levels = m_topology->levels;
+#pragma omp parallel if(m_parallel)
         {
-            auto node = *node_it;
-            if(lemon::countOutArcs(m_topology->g.G(), node) > 0)
+            for(std::size_t l = levels.size(); l > 0; --l)
             {
-                SlewType required = MergeStrategy::worst();
-                for(lemon::ListDigraph::OutArcIt arc(m_topology->g.G(), node); arc != lemon::INVALID; ++arc)
-                    required = m_merge.inverted(required, m_timing.nodes.required(m_topology->g.edge_target(arc))-m_timing.arcs.delay(arc));
-                m_timing.nodes.required(node, required);
+                const std::vector<csr_graph::index> & level = levels[l-1];
+                std::size_t i;
+#pragma omp for schedule(dynamic, 16)
+                for(i = 0; i < level.size(); ++i)
+                {
+                    const csr_graph::index driver = level[i];
+                    for(auto a = G.out_arcs_begin(driver); a != G.out_arcs_end(driver); ++a)
+                    {
+                        const csr_graph::index sink = G.target(a);
+                        if(m_topology->driver_level[sink] == -1 && G.out_degree(sink) > 0)
+                            update_required(sink);
+                    }
+                    if(G.out_degree(driver) > 0)
+                        update_required(driver);
+                }
+            }
+        }
+        for(auto node : m_topology->unleveled)
+            update_required(node);
+        store_test_requireds();
+    }
+
+    // drivers recomputed by the last incremental_update_ats()
+    const std::vector<csr_graph::index> & updated_drivers() const {
+        return m_updated_drivers;
+    }
+
+    // Backward counterpart of incremental_update_ats(). The nodes whose outgoing
+    // arcs got new delays and the fanin of the tests whose required time changed
+    // are visited in reverse topological order, and a node only propagates to its
+    // fanin when its required time changes in some corner. Only the given tests,
+    // the ones recomputed since the last update, are compared and stored.
+    void incremental_update_rts(const std::vector<std::size_t> & recomputed_tests) {
+        const csr_graph & G = m_topology->csr;
+        const std::vector<test> & tests = m_topology->g.tests();
+        if(m_test_requireds.size() != tests.size()*m_corners.size())
+        {
+            update_rts();
+            m_updated_sinks.resize(G.node_count());
+            std::iota(m_updated_sinks.begin(), m_updated_sinks.end(), 0);
+            return;
+        }
+        if(m_queued.size() != G.node_count())
+            m_queued.assign(G.node_count(), 0);
+
+        std::priority_queue< csr_graph::index > pending;
+        auto enqueue = [this, &pending](csr_graph::index node) {
+            if(!m_queued[node])
+            {
+                m_queued[node] = 1;
+                pending.push(node);
+            }
+        };
+        auto enqueue_fanin = [&G, &enqueue](csr_graph::index node) {
+            for(auto it = G.in_arcs_begin(node); it != G.in_arcs_end(node); ++it)
+                enqueue(G.source(*it));
+        };
+        m_updated_sinks.clear();
+        for(auto node : m_updated_drivers)
+        {
+            enqueue(node);
+            enqueue_fanin(node);
+            for(auto a = G.out_arcs_begin(node); a != G.out_arcs_end(node); ++a)
+                m_updated_sinks.push_back(G.target(a));
+        }
+        for(auto i : recomputed_tests)
+        {
+            if(test_required_changed(i))
+            {
+                enqueue_fanin(G.node_index(tests[i].d));
+                m_updated_sinks.push_back(G.node_index(tests[i].d));
             }
         }
+
+        while(!pending.empty())
+        {
+            auto node = pending.top();
+            pending.pop();
+            // the fanout of a node is popped before it, so it can not be queued again
+            m_queued[node] = 0;
+            if(G.out_degree(node) == 0)
+                continue;
+            if(update_required(node))
+                enqueue_fanin(node);
+        }
+        m_updated_drivers.clear();
+        store_test_requireds(recomputed_tests);
     }
 
 
-    lemon::Path<lemon::ListDigraph> critical_path() const {
+    // sinks whose arrival or required time may have changed in the last
+    // incremental_update_rts(), possibly repeated
+    const std::vector<csr_graph::index> & updated_sinks() const {
+        return m_updated_sinks;
+    }
+
+    lemon::Path<lemon::ListDigraph> critical_path(std::size_t corner = 0) const {
+        const csr_graph & G = m_topology->csr;
+        const timing_data & timing = *m_corners[corner];
         lemon::Path<lemon::ListDigraph> cp;
         SlewType worst_slack = std::numeric_limits<SlewType>::infinity();
-        lemon::ListDigraph::Node worst_PO;
-        for(auto node_it = m_topology->sorted.rbegin(); node_it != m_topology->sorted.rend(); ++node_it)
+        csr_graph::index worst_PO = std::numeric_limits<csr_graph::index>::max();
+        for(std::size_t i = G.node_count(); i > 0; --i)
         {
-            auto node = *node_it;
-            if(lemon::countOutArcs(m_topology->g.G(), node) == 0)
+            const csr_graph::index node = static_cast<csr_graph::index>(i-1);
+            if(G.out_degree(node) == 0)
             {
-                SlewType current_PO_slack = MergeStrategy::slack_signal()*(m_timing.nodes.required(node)-m_timing.nodes.arrival(node));
+                SlewType current_PO_slack = MergeStrategy::slack_signal()*(timing.nodes.required(G.node(node))-timing.nodes.arrival(G.node(node)));
                 if(current_PO_slack < worst_slack)
                 {
                     worst_slack = current_PO_slack;
@@ -353,27 +677,27 @@ public:
                 }
             }
         }
-        lemon::ListDigraph::Node current_node = worst_PO;
-        lemon::ListDigraph::Node next_node = current_node;
-        while(next_node != lemon::INVALID)
+        if(worst_PO == std::numeric_limits<csr_graph::index>::max())
+            return cp;
+        csr_graph::index current_node = worst_PO;
+        while(true)
         {
-            current_node = next_node;
-            next_node = lemon::INVALID;
-            lemon::ListDigraph::Arc worst_arc = lemon::INVALID;
+            csr_graph::index worst_arc = std::numeric_limits<csr_graph::index>::max();
             SlewType worst_slack_input = std::numeric_limits<SlewType>::infinity();
-            for(lemon::ListDigraph::InArcIt in(m_topology->g.G(), current_node); in != lemon::INVALID; ++in)
+            for(auto in = G.in_arcs_begin(current_node); in != G.in_arcs_end(current_node); ++in)
             {
-                auto source = m_topology->g.G().source(in);
-                SlewType slack = MergeStrategy::slack_signal()*(m_timing.nodes.required(source)-m_timing.nodes.arrival(source));
+                auto source = G.node(G.source(*in));
+                SlewType slack = MergeStrategy::slack_signal()*(timing.nodes.required(source)-timing.nodes.arrival(source));
                 if(slack < worst_slack_input)
                 {
                     worst_slack_input = slack;
-                    worst_arc = in;
-                    next_node = source;
+                    worst_arc = *in;
                 }
             }
-            if(worst_arc != lemon::INVALID)
-                cp.addFront(worst_arc);
+            if(worst_arc == std::numeric_limits<csr_graph::index>::max())
+                break;
+            cp.addFront(G.arc(worst_arc));
+            current_node = G.source(worst_arc);
         }
         return cp;
     }
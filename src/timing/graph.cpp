@@ -19,6 +19,7 @@ under the License.
  */
 
 #include "graph.h"
+#include <cassert>
 
 namespace ophidian {
 namespace timing {
@@ -27,7 +28,8 @@ graph::graph() :
 		m_pins(m_graph),
 		m_node_edges(m_graph),
 		m_arc_types(m_graph),
-		m_arcs(m_graph){
+		m_arcs(m_graph),
+		m_pin_system(nullptr){
 }
 
 graph::~graph() {
@@ -38,15 +40,25 @@ void graph::test_insert(node ck, node d, entity_system::entity tarc)
     m_tests.push_back(test{ck, d, tarc});
 }
 
-graph::node graph::node_create(entity_system::entity pin, edges node_edge, std::unordered_map<entity_system::entity, node> &map) {
+graph::node graph::node_create(entity_system::entity pin, edges node_edge, std::vector<node> &nodes) {
 	auto new_node = m_graph.addNode();
-	if(map.find(pin) == map.end())
-		map[pin] = new_node;
+	const std::size_t index = pin_index(pin);
+	if(index >= nodes.size())
+		nodes.resize(index+1, lemon::INVALID);
+	if(nodes[index] == lemon::INVALID)
+		nodes[index] = new_node;
 	m_pins[new_node] = pin;
 	m_node_edges[new_node] = node_edge;
 	return new_node;
 }
 
+void graph::pin_system(const entity_system::entity_system & pins) {
+	assert(m_rise_nodes.empty() && m_fall_nodes.empty());
+	m_pin_system = &pins;
+	m_rise_nodes.reserve(pins.size());
+	m_fall_nodes.reserve(pins.size());
+}
+
 graph::node graph::rise_node_create(entity_system::entity pin) {
 	return node_create(pin, edges::RISE, m_rise_nodes);
 }
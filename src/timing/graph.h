@@ -24,7 +24,8 @@ under the License.
 #include <lemon/list_graph.h>
 #include "../entity_system/entity_system.h"
 #include "transition.h"
-#include <unordered_map>
+#include <stdexcept>
+#include <vector>
 
 namespace ophidian {
 namespace timing {
@@ -55,12 +56,25 @@ private:
     lemon::ListDigraph::ArcMap< entity_system::entity > m_arcs;
 
 
-    std::unordered_map< entity_system::entity, node > m_rise_nodes;
-    std::unordered_map< entity_system::entity, node > m_fall_nodes;
+    // first node created for each pin, indexed by the pin index (or by the raw entity without a pin system)
+    const entity_system::entity_system * m_pin_system;
+    std::vector< node > m_rise_nodes;
+    std::vector< node > m_fall_nodes;
 
     std::vector< test > m_tests;
 
-    node node_create(entity_system::entity pin, edges node_edge, std::unordered_map<entity_system::entity, node> &map);
+    node node_create(entity_system::entity pin, edges node_edge, std::vector<node> &nodes);
+
+    std::size_t pin_index(entity_system::entity pin) const {
+        return m_pin_system ? static_cast<std::size_t>(m_pin_system->lookup(pin)) : static_cast<std::size_t>(pin);
+    }
+
+    node pin_node(const std::vector<node> & nodes, entity_system::entity pin) const {
+        const std::size_t index = pin_index(pin);
+        if(index >= nodes.size() || nodes[index] == lemon::INVALID)
+            throw std::out_of_range("graph: pin without node");
+        return nodes[index];
+    }
 
 
 
@@ -81,6 +95,10 @@ public:
     }
 
 
+    // indexes the pin nodes by the pins' index in pin_system; must be set before creating nodes
+    // and the graph must be rebuilt after pins are destroyed
+    void pin_system(const entity_system::entity_system & pins);
+
     std::size_t nodes_count() const {
         return lemon::countNodes(m_graph);
     }
@@ -91,12 +109,12 @@ public:
 
     node rise_node_create(entity_system::entity pin);
     node rise_node(entity_system::entity pin) const {
-        return m_rise_nodes.at(pin);
+        return pin_node(m_rise_nodes, pin);
     }
 
     node fall_node_create(entity_system::entity pin);
     node fall_node(entity_system::entity pin) const {
-        return m_fall_nodes.at(pin);
+        return pin_node(m_fall_nodes, pin);
     }
 
     void node_edge(node u, edges e);
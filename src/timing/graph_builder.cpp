@@ -19,6 +19,7 @@ under the License.
  */
 
 #include "graph_builder.h"
+#include <unordered_map>
 
 namespace ophidian {
 namespace timing {
@@ -35,6 +36,7 @@ void graph_builder::build(const netlist::netlist & netlist, library & lib, const
 
     std::cout << "  graph_builder::build(): creating two nodes for each pin" << std::endl << std::flush;
     // create a node for each pin
+    graph.pin_system(netlist.pin_system());
     for (auto pin : netlist.pin_system())
         util::transitions<graph::node> node { graph.rise_node_create(pin), graph.fall_node_create(pin) };
 
@@ -21,7 +21,20 @@ under the License.
 #include "liberty.h"
 #include <si2dr_liberty.h>
 #include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <boost/units/systems/si.hpp>
 #include <boost/units/io.hpp>
@@ -33,14 +46,442 @@ namespace liberty {
 
 si2drErrorT err;
 
+namespace {
+
+// Compiled form of a Liberty file: flat arrays of plain records, each cell
+// owning a range of pins, each pin a range of timing arcs and each arc a range
+// of tables. It is written to the cache as is and a mapped cache is read in
+// place. Values are stored in SI units.
+
+const char cache_magic[8] = {'O', 'P', 'H', 'L', 'I', 'B', '\0', '\0'};
+const std::uint32_t cache_version = 1;
+const std::uint32_t cache_byte_order = 0x01020304;
+
+enum table_kinds : std::uint32_t {
+    RISE_DELAY, FALL_DELAY, RISE_SLEW, FALL_SLEW, SETUP_RISE, SETUP_FALL, HOLD_RISE, HOLD_FALL
+};
+
+const std::uint8_t no_direction = 0, input_direction = 1, output_direction = 2;
+const std::uint8_t no_sense = 255;
+
+struct cell_record {
+    std::uint64_t name;
+    std::uint32_t name_size;
+    std::uint32_t sequential;
+    std::uint32_t pins_begin;
+    std::uint32_t pins_end;
+};
+
+struct pin_record {
+    double capacitance;
+    std::uint64_t name;
+    std::uint32_t name_size;
+    std::uint32_t arcs_begin;
+    std::uint32_t arcs_end;
+    std::uint8_t direction;
+    std::uint8_t clock;
+    std::uint8_t has_capacitance;
+    std::uint8_t padding;
+};
+
+struct arc_record {
+    std::uint64_t from; // name of the related pin
+    std::uint32_t from_size;
+    std::uint8_t has_from;
+    std::uint8_t type;
+    std::uint8_t sense;
+    std::uint8_t padding;
+    std::uint32_t tables_begin;
+    std::uint32_t tables_end;
+};
+
+struct table_record {
+    std::uint32_t kind;
+    std::uint32_t lut;
+};
+
+// rows row values, then columns column values, then the values row by row
+struct lut_record {
+    std::uint64_t values;
+    std::uint32_t rows;
+    std::uint32_t columns;
+};
+
+struct cache_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t source_size;
+    std::uint64_t source_hash;
+    std::uint64_t strings;
+    std::uint64_t cells;
+    std::uint64_t pins;
+    std::uint64_t arcs;
+    std::uint64_t tables;
+    std::uint64_t luts;
+    std::uint64_t doubles;
+};
+
+static_assert(sizeof(cell_record) == 24 && sizeof(pin_record) == 32 && sizeof(arc_record) == 24, "cache records must have no implicit padding");
+static_assert(sizeof(table_record) == 8 && sizeof(lut_record) == 16 && sizeof(cache_header) == 88, "cache records must have no implicit padding");
+
+std::uint64_t padded(std::uint64_t size) {
+    return (size + 7) & ~static_cast<std::uint64_t>(7);
+}
+
+struct library_view {
+    const char * strings;
+    const cell_record * cells;
+    std::size_t cell_count;
+    const pin_record * pins;
+    const arc_record * arcs;
+    const table_record * tables;
+    const lut_record * luts;
+    const double * doubles;
+
+    std::string string(std::uint64_t offset, std::uint32_t size) const {
+        return std::string(strings + offset, size);
+    }
+};
+
+struct compiled_library {
+    std::string strings;
+    std::vector<cell_record> cells;
+    std::vector<pin_record> pins;
+    std::vector<arc_record> arcs;
+    std::vector<table_record> tables;
+    std::vector<lut_record> luts;
+    std::vector<double> doubles;
+
+    std::uint64_t add_string(const std::string & value) {
+        const std::uint64_t offset = strings.size();
+        strings += value;
+        return offset;
+    }
+
+    template <class Table>
+    void add_table(table_kinds kind, const Table & table) {
+        tables.push_back(table_record{kind, static_cast<std::uint32_t>(luts.size())});
+        luts.push_back(lut_record{doubles.size(), static_cast<std::uint32_t>(table.row_count()), static_cast<std::uint32_t>(table.column_count())});
+        for(std::size_t i = 0; i < table.row_count(); ++i)
+            doubles.push_back(table.row_value(i).value());
+        for(std::size_t j = 0; j < table.column_count(); ++j)
+            doubles.push_back(table.column_value(j).value());
+        for(std::size_t i = 0; i < table.row_count(); ++i)
+            for(std::size_t j = 0; j < table.column_count(); ++j)
+                doubles.push_back(table.at(i, j).value());
+    }
+
+    library_view view() const {
+        return library_view{strings.data(), cells.data(), cells.size(), pins.data(), arcs.data(), tables.data(), luts.data(), doubles.data()};
+    }
+};
+
+template <class Table, class RowType, class ColumnType, class ValueType>
+Table make_table(const library_view & view, std::uint32_t lut) {
+    const lut_record & record = view.luts[lut];
+    Table table(record.rows, record.columns);
+    const double * values = view.doubles + record.values;
+    for(std::uint32_t i = 0; i < record.rows; ++i)
+        table.row_value(i, RowType::from_value(*values++));
+    for(std::uint32_t j = 0; j < record.columns; ++j)
+        table.column_value(j, ColumnType::from_value(*values++));
+    for(std::uint32_t i = 0; i < record.rows; ++i)
+        for(std::uint32_t j = 0; j < record.columns; ++j)
+            table.at(i, j, ValueType::from_value(*values++));
+    return table;
+}
+
+// creates the cells, pins and arcs in the same order as the parser did
+void populate(const library_view & view, timing::library & library) {
+    using LUT = library::LUT;
+    using TestLUT = library::TestLUT;
+    using CapacitanceType = library::CapacitanceType;
+    using SlewType = library::SlewType;
+    for(std::size_t c = 0; c < view.cell_count; ++c)
+    {
+        const cell_record & cell = view.cells[c];
+        auto cell_entity = library.cell_create(view.string(cell.name, cell.name_size));
+        if(cell.sequential)
+            library.cell_sequential(cell_entity, true);
+        for(std::uint32_t p = cell.pins_begin; p < cell.pins_end; ++p)
+        {
+            const pin_record & pin = view.pins[p];
+            auto pin_entity = library.pin_create(cell_entity, view.string(pin.name, pin.name_size));
+            if(pin.has_capacitance)
+                library.pin_capacitance(pin_entity, CapacitanceType::from_value(pin.capacitance));
+            if(pin.clock)
+            {
+                library.pin_clock_input(pin_entity, true);
+                library.cell_sequential(cell_entity, true);
+            }
+            if(pin.direction == input_direction)
+                library.std_cells().pin_direction(pin_entity, standard_cell::pin_directions::INPUT);
+            else if(pin.direction == output_direction)
+                library.std_cells().pin_direction(pin_entity, standard_cell::pin_directions::OUTPUT);
+
+            for(std::uint32_t a = pin.arcs_begin; a < pin.arcs_end; ++a)
+            {
+                const arc_record & record = view.arcs[a];
+                entity_system::entity from;
+                if(record.has_from)
+                    from = library.std_cells().pin_create(library.std_cells().pin_owner(pin_entity), view.string(record.from, record.from_size));
+                auto arc = library.timing_arc_create(from, pin_entity);
+                library.timing_arc_timing_type(arc, static_cast<timing_arc_types>(record.type));
+                if(record.sense != no_sense)
+                    library.timing_arc_timing_sense(arc, static_cast<unateness>(record.sense));
+                for(std::uint32_t t = record.tables_begin; t < record.tables_end; ++t)
+                {
+                    const table_record & table = view.tables[t];
+                    switch(table.kind)
+                    {
+                    case RISE_DELAY:
+                        library.timing_arc_rise_delay(arc, make_table<LUT, CapacitanceType, SlewType, SlewType>(view, table.lut));
+                        break;
+                    case FALL_DELAY:
+                        library.timing_arc_fall_delay(arc, make_table<LUT, CapacitanceType, SlewType, SlewType>(view, table.lut));
+                        break;
+                    case RISE_SLEW:
+                        library.timing_arc_rise_slew(arc, make_table<LUT, CapacitanceType, SlewType, SlewType>(view, table.lut));
+                        break;
+                    case FALL_SLEW:
+                        library.timing_arc_fall_slew(arc, make_table<LUT, CapacitanceType, SlewType, SlewType>(view, table.lut));
+                        break;
+                    case SETUP_RISE:
+                        library.setup_rise_create(arc, make_table<TestLUT, SlewType, SlewType, SlewType>(view, table.lut));
+                        break;
+                    case SETUP_FALL:
+                        library.setup_fall_create(arc, make_table<TestLUT, SlewType, SlewType, SlewType>(view, table.lut));
+                        break;
+                    case HOLD_RISE:
+                        library.hold_rise_create(arc, make_table<TestLUT, SlewType, SlewType, SlewType>(view, table.lut));
+                        break;
+                    case HOLD_FALL:
+                        library.hold_fall_create(arc, make_table<TestLUT, SlewType, SlewType, SlewType>(view, table.lut));
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+class mapped_file {
+    int m_file;
+    const char * m_data;
+    std::size_t m_size;
+public:
+    explicit mapped_file(const std::string & filename) :
+        m_file(open(filename.c_str(), O_RDONLY)),
+        m_data(nullptr),
+        m_size(0)
+    {
+        if(m_file < 0)
+            throw std::runtime_error("liberty: cannot open " + filename);
+        struct stat status;
+        if(fstat(m_file, &status) != 0)
+        {
+            close(m_file);
+            throw std::runtime_error("liberty: cannot stat " + filename);
+        }
+        m_size = static_cast<std::size_t>(status.st_size);
+        if(m_size > 0)
+        {
+            void * data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+            if(data == MAP_FAILED)
+            {
+                close(m_file);
+                throw std::runtime_error("liberty: cannot map " + filename);
+            }
+            m_data = static_cast<const char*>(data);
+        }
+    }
+    ~mapped_file() {
+        if(m_data)
+            munmap(const_cast<char*>(m_data), m_size);
+        close(m_file);
+    }
+    mapped_file(const mapped_file &) = delete;
+    mapped_file & operator=(const mapped_file &) = delete;
+
+    const char * data() const {
+        return m_data;
+    }
+    std::size_t size() const {
+        return m_size;
+    }
+};
+
+// 64 bit FNV-1a
+std::uint64_t hash(const char * data, std::size_t size) {
+    std::uint64_t value = 14695981039346656037ULL;
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        value ^= static_cast<unsigned char>(data[i]);
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
+
+bool string_in(const cache_header & header, std::uint64_t offset, std::uint32_t size) {
+    return offset <= header.strings && size <= header.strings - offset;
+}
+
+bool range_in(std::uint32_t begin, std::uint32_t end, std::uint64_t count) {
+    return begin <= end && end <= count;
+}
+
+// checks every name, range and index of the records against the header counts
+bool valid_records(const cache_header & header, const library_view & view) {
+    for(std::size_t c = 0; c < header.cells; ++c)
+    {
+        const cell_record & cell = view.cells[c];
+        if(!string_in(header, cell.name, cell.name_size) || !range_in(cell.pins_begin, cell.pins_end, header.pins))
+            return false;
+    }
+    for(std::size_t p = 0; p < header.pins; ++p)
+    {
+        const pin_record & pin = view.pins[p];
+        if(!string_in(header, pin.name, pin.name_size) || !range_in(pin.arcs_begin, pin.arcs_end, header.arcs) || pin.direction > output_direction)
+            return false;
+    }
+    for(std::size_t a = 0; a < header.arcs; ++a)
+    {
+        const arc_record & arc = view.arcs[a];
+        if((arc.has_from && !string_in(header, arc.from, arc.from_size)) || !range_in(arc.tables_begin, arc.tables_end, header.tables))
+            return false;
+        if(arc.type > static_cast<std::uint8_t>(timing_arc_types::RISING_EDGE) || (arc.sense != no_sense && arc.sense > static_cast<std::uint8_t>(unateness::NON_UNATE)))
+            return false;
+    }
+    for(std::size_t t = 0; t < header.tables; ++t)
+        if(view.tables[t].kind > HOLD_FALL || view.tables[t].lut >= header.luts)
+            return false;
+    for(std::size_t l = 0; l < header.luts; ++l)
+    {
+        const lut_record & lut = view.luts[l];
+        const std::uint64_t values = std::uint64_t(lut.rows) + lut.columns + std::uint64_t(lut.rows)*lut.columns;
+        if(lut.values > header.doubles || values > header.doubles - lut.values)
+            return false;
+    }
+    return true;
+}
+
+// points the view into a mapped cache; false when the cache is not from this
+// version, does not match the source or has a record out of its arrays
+bool map_cache(const mapped_file & cache, std::uint64_t source_size, std::uint64_t source_hash, library_view & view) {
+    if(cache.size() < sizeof(cache_header))
+        return false;
+    cache_header header;
+    std::memcpy(&header, cache.data(), sizeof(cache_header));
+    if(std::memcmp(header.magic, cache_magic, sizeof(cache_magic)) != 0 || header.version != cache_version || header.byte_order != cache_byte_order)
+        return false;
+    if(header.source_size != source_size || header.source_hash != source_hash)
+        return false;
+    // every count fits in the file, so the total below can not overflow
+    for(std::uint64_t count : {header.strings, header.cells, header.pins, header.arcs, header.tables, header.luts, header.doubles})
+        if(count > cache.size())
+            return false;
+    const std::uint64_t size = sizeof(cache_header) + padded(header.strings) + header.cells*sizeof(cell_record) + header.pins*sizeof(pin_record)
+            + header.arcs*sizeof(arc_record) + header.tables*sizeof(table_record) + header.luts*sizeof(lut_record) + header.doubles*sizeof(double);
+    if(size != cache.size())
+        return false;
+
+    const char * it = cache.data() + sizeof(cache_header);
+    view.strings = it;
+    it += padded(header.strings);
+    view.cells = reinterpret_cast<const cell_record*>(it);
+    view.cell_count = header.cells;
+    it += header.cells*sizeof(cell_record);
+    view.pins = reinterpret_cast<const pin_record*>(it);
+    it += header.pins*sizeof(pin_record);
+    view.arcs = reinterpret_cast<const arc_record*>(it);
+    it += header.arcs*sizeof(arc_record);
+    view.tables = reinterpret_cast<const table_record*>(it);
+    it += header.tables*sizeof(table_record);
+    view.luts = reinterpret_cast<const lut_record*>(it);
+    it += header.luts*sizeof(lut_record);
+    view.doubles = reinterpret_cast<const double*>(it);
+    return valid_records(header, view);
+}
+
+template <class T>
+void write_array(std::ostream & out, const std::vector<T> & values) {
+    out.write(reinterpret_cast<const char*>(values.data()), values.size()*sizeof(T));
+}
+
+// writes to a temporary file renamed at the end, so a reader never maps half a cache
+void write_cache(const std::string & filename, const compiled_library & compiled, std::uint64_t source_size, std::uint64_t source_hash) {
+    cache_header header;
+    std::memset(&header, 0, sizeof(cache_header));
+    std::memcpy(header.magic, cache_magic, sizeof(cache_magic));
+    header.version = cache_version;
+    header.byte_order = cache_byte_order;
+    header.source_size = source_size;
+    header.source_hash = source_hash;
+    header.strings = compiled.strings.size();
+    header.cells = compiled.cells.size();
+    header.pins = compiled.pins.size();
+    header.arcs = compiled.arcs.size();
+    header.tables = compiled.tables.size();
+    header.luts = compiled.luts.size();
+    header.doubles = compiled.doubles.size();
+
+    // a unique name in the same directory, so concurrent writers do not share it
+    std::vector<char> name(filename.begin(), filename.end());
+    const char suffix[] = ".XXXXXX";
+    name.insert(name.end(), suffix, suffix + sizeof(suffix));
+    const int file = mkstemp(name.data());
+    if(file < 0)
+        return;
+    fchmod(file, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    close(file);
+    const std::string temporary(name.data());
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if(!out)
+        {
+            std::remove(temporary.c_str());
+            return;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(cache_header));
+        out.write(compiled.strings.data(), compiled.strings.size());
+        const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        out.write(zeros, padded(compiled.strings.size()) - compiled.strings.size());
+        write_array(out, compiled.cells);
+        write_array(out, compiled.pins);
+        write_array(out, compiled.arcs);
+        write_array(out, compiled.tables);
+        write_array(out, compiled.luts);
+        write_array(out, compiled.doubles);
+        if(!out)
+        {
+            out.close();
+            std::remove(temporary.c_str());
+            return;
+        }
+    }
+    if(std::rename(temporary.c_str(), filename.c_str()) != 0)
+        std::remove(temporary.c_str());
+}
+
+}
+
 namespace parser {
 
-std::vector<double> split_string_into_values(const std::string &the_string) {
+std::vector<double> split_string_into_values(const char * the_string) {
     std::vector<double> values;
-    std::stringstream input(the_string);
-    std::string segment;
-    while (std::getline(input, segment, ','))
-        values.push_back(std::stod(segment));
+    const char * it = the_string;
+    while (true) {
+        char * end;
+        const double value = std::strtod(it, &end);
+        if (end == it)
+            break;
+        values.push_back(value);
+        it = std::strchr(end, ',');
+        if (!it)
+            break;
+        ++it;
+    }
     return values;
 }
 
@@ -69,7 +510,7 @@ void read_LUT(si2drGroupIdT group, boost::units::quantity<boost::units::si::time
 
             std::size_t i = 0;
             do {
-                std::vector<double> values_vector = split_string_into_values(std::string { string_val });
+                std::vector<double> values_vector = split_string_into_values(string_val);
 
                 if (name == "index_1") {
                     for (auto v : values_vector)
@@ -146,7 +587,7 @@ void read_constraint(si2drGroupIdT group, library::TestLUT*& test_LUT, boost::un
     si2drIterQuit(attrs, &err);
 }
 
-void read_LUTs(si2drGroupIdT timing, entity_system::entity arc, library& library, boost::units::quantity<boost::units::si::time> time_unit, boost::units::quantity<boost::units::si::capacitance> capacitive_load_unit, bool setup, bool hold) {
+void read_LUTs(si2drGroupIdT timing, compiled_library& library, boost::units::quantity<boost::units::si::time> time_unit, boost::units::quantity<boost::units::si::capacitance> capacitive_load_unit, bool setup, bool hold) {
 
     si2drGroupsIdT groups = si2drGroupGetGroups(timing, &err);
     si2drGroupIdT group;
@@ -158,17 +599,17 @@ void read_LUTs(si2drGroupIdT timing, entity_system::entity arc, library& library
             {
                 read_constraint(group, test_lut, time_unit);
                 if(hold)
-                    library.hold_rise_create(arc, *test_lut);
+                    library.add_table(HOLD_RISE, *test_lut);
                 else if(setup)
-                    library.setup_rise_create(arc, *test_lut);
+                    library.add_table(SETUP_RISE, *test_lut);
             }
         } else if (group_type == "fall_constraint") {
             {
                 read_constraint(group, test_lut, time_unit);
                 if(hold)
-                    library.hold_fall_create(arc, *test_lut);
+                    library.add_table(HOLD_FALL, *test_lut);
                 else if(setup)
-                    library.setup_fall_create(arc, *test_lut);
+                    library.add_table(SETUP_FALL, *test_lut);
             }
         } else {
 
@@ -176,13 +617,13 @@ void read_LUTs(si2drGroupIdT timing, entity_system::entity arc, library& library
             read_LUT(group, time_unit, capacitive_load_unit, lut);
             assert(lut);
             if (group_type == "cell_fall") {
-                library.timing_arc_fall_delay(arc, *lut);
+                library.add_table(FALL_DELAY, *lut);
             } else if (group_type == "cell_rise") {
-                library.timing_arc_rise_delay(arc, *lut);
+                library.add_table(RISE_DELAY, *lut);
             } else if (group_type == "fall_transition") {
-                library.timing_arc_fall_slew(arc, *lut);
+                library.add_table(FALL_SLEW, *lut);
             } else if (group_type == "rise_transition") {
-                library.timing_arc_rise_slew(arc, *lut);
+                library.add_table(RISE_SLEW, *lut);
             } else
                 assert(false);
             delete lut;
@@ -193,14 +634,14 @@ void read_LUTs(si2drGroupIdT timing, entity_system::entity arc, library& library
 
 }
 
-void read_timing(si2drGroupIdT timing, entity_system::entity pin_entity, library& library, boost::units::quantity<boost::units::si::time> time_unit, boost::units::quantity<boost::units::si::capacitance> capacitive_load_unit) {
+void read_timing(si2drGroupIdT timing, compiled_library& library, boost::units::quantity<boost::units::si::time> time_unit, boost::units::quantity<boost::units::si::capacitance> capacitive_load_unit) {
 
     std::string timing_sense { "negative_unate" };
     std::string timing_type { "combinational" };
     std::string related_pin { "default_related_pin" };
     si2drAttrsIdT attrs = si2drGroupGetAttrs(timing, &err);
     si2drAttrIdT attr;
-    entity_system::entity from;
+    arc_record arc{0, 0, 0, static_cast<std::uint8_t>(timing_arc_types::COMBINATIONAL), no_sense, 0, 0, 0};
 
     while (!si2drObjectIsNull((attr = si2drIterNextAttr(attrs, &err)), &err)) {
         std::string attr_name { si2drAttrGetName(attr, &err) };
@@ -210,7 +651,9 @@ void read_timing(si2drGroupIdT timing, entity_system::entity pin_entity, library
             timing_type = si2drSimpleAttrGetStringValue(attr, &err);
         else if (attr_name == "related_pin") {
             related_pin = si2drSimpleAttrGetStringValue(attr, &err);
-            from = library.std_cells().pin_create(library.std_cells().pin_owner(pin_entity), related_pin);
+            arc.from = library.add_string(related_pin);
+            arc.from_size = static_cast<std::uint32_t>(related_pin.size());
+            arc.has_from = 1;
         }
     }
     si2drIterQuit(attrs, &err);
@@ -232,16 +675,14 @@ void read_timing(si2drGroupIdT timing, entity_system::entity pin_entity, library
     else if(timing_type=="rising_edge")
         type = timing_arc_types::RISING_EDGE;
 
-    auto arc = library.timing_arc_create(from, pin_entity);
-
-    library.timing_arc_timing_type(arc, type);
+    arc.type = static_cast<std::uint8_t>(type);
 
     if (timing_sense == "negative_unate")
-        library.timing_arc_timing_sense(arc, unateness::NEGATIVE_UNATE);
+        arc.sense = static_cast<std::uint8_t>(unateness::NEGATIVE_UNATE);
     else if (timing_sense == "positive_unate")
-        library.timing_arc_timing_sense(arc, unateness::POSITIVE_UNATE);
+        arc.sense = static_cast<std::uint8_t>(unateness::POSITIVE_UNATE);
     else if (timing_sense == "non_unate")
-        library.timing_arc_timing_sense(arc, unateness::NON_UNATE);
+        arc.sense = static_cast<std::uint8_t>(unateness::NON_UNATE);
     //	timing_info.timingSense = timing_sense;
     //	timing_info.timing_type = Liberty_Timing_Type::Combinational;
     //	if(timing_type == "setup_rising")
@@ -257,17 +698,21 @@ void read_timing(si2drGroupIdT timing, entity_system::entity pin_entity, library
     //    std::cout << "      timing sense: " << timing_sense << std::endl;
     //    std::cout << "      timing type: " << timing_type << std::endl;
 
-    read_LUTs(timing, arc, library, time_unit, capacitive_load_unit, setup, hold);
+    arc.tables_begin = static_cast<std::uint32_t>(library.tables.size());
+    read_LUTs(timing, library, time_unit, capacitive_load_unit, setup, hold);
+    arc.tables_end = static_cast<std::uint32_t>(library.tables.size());
+    library.arcs.push_back(arc);
 
 }
 
-void read_pin(entity_system::entity cell_entity, si2drGroupIdT pin, library& library, boost::units::quantity<boost::units::si::time> time_unit, boost::units::quantity<boost::units::si::capacitance> capacitive_load_unit) {
+void read_pin(si2drGroupIdT pin, compiled_library& library, boost::units::quantity<boost::units::si::time> time_unit, boost::units::quantity<boost::units::si::capacitance> capacitive_load_unit) {
 
     si2drNamesIdT current_cell_group_names = si2drGroupGetNames(pin, &err);
     std::string pin_name { si2drIterNextName(current_cell_group_names, &err) };
     si2drIterQuit(current_cell_group_names, &err);
-    si2StringT direction;
-    auto pin_entity = library.pin_create(cell_entity, pin_name);
+    si2StringT direction = nullptr;
+    const std::size_t pin_index = library.pins.size();
+    library.pins.push_back(pin_record{0.0, library.add_string(pin_name), static_cast<std::uint32_t>(pin_name.size()), 0, 0, no_direction, 0, 0, 0});
 
     si2drAttrsIdT attrs = si2drGroupGetAttrs(pin, &err);
     si2drAttrIdT attr;
@@ -279,20 +724,20 @@ void read_pin(entity_system::entity cell_entity, si2drGroupIdT pin, library& lib
         //		else if (attr_name == "max_capacitance")
         //			max_capacitance = si2drSimpleAttrGetFloat64Value(attr, &err);
         else if (attr_name == "capacitance")
-            library.pin_capacitance(pin_entity, si2drSimpleAttrGetFloat64Value(attr, &err) * capacitive_load_unit);
-        else if (attr_name == "clock")
         {
-            library.pin_clock_input(pin_entity, true);
-            library.cell_sequential(cell_entity, true);
+            library.pins[pin_index].capacitance = (si2drSimpleAttrGetFloat64Value(attr, &err) * capacitive_load_unit).value();
+            library.pins[pin_index].has_capacitance = 1;
         }
+        else if (attr_name == "clock")
+            library.pins[pin_index].clock = 1;
         //			is_clock = si2drSimpleAttrGetBooleanValue(attr, &err);
     }
     si2drIterQuit(attrs, &err);
 
-    if (std::string(direction) == "input")
-        library.std_cells().pin_direction(pin_entity, standard_cell::pin_directions::INPUT);
-    else if (std::string(direction) == "output")
-        library.std_cells().pin_direction(pin_entity, standard_cell::pin_directions::OUTPUT);
+    if (direction && std::string(direction) == "input")
+        library.pins[pin_index].direction = input_direction;
+    else if (direction && std::string(direction) == "output")
+        library.pins[pin_index].direction = output_direction;
 
     //    std::cout << "    direction: " << direction << std::endl;
     //    std::cout << "    max_capacitance: " << max_capacitance << std::endl;
@@ -307,6 +752,7 @@ void read_pin(entity_system::entity cell_entity, si2drGroupIdT pin, library& lib
     //	if (is_clock)
     //		cell_type.isSequential = true;
     //
+    library.pins[pin_index].arcs_begin = static_cast<std::uint32_t>(library.arcs.size());
     si2drGroupsIdT groups = si2drGroupGetGroups(pin, &err);
     si2drGroupIdT group;
     while (!si2drObjectIsNull((group = si2drIterNextGroup(groups, &err)), &err)) {
@@ -314,21 +760,23 @@ void read_pin(entity_system::entity cell_entity, si2drGroupIdT pin, library& lib
         if (group_type == "timing") {
             //			Liberty_Library_Timing_Info timing_info;
             //			timing_info.toPin = cell_pin.name;
-            read_timing(group, pin_entity, library, time_unit, capacitive_load_unit);
+            read_timing(group, library, time_unit, capacitive_load_unit);
             //			cell_type.timingArcs.push_back(timing_info);
         }
     }
     si2drIterQuit(groups, &err);
+    library.pins[pin_index].arcs_end = static_cast<std::uint32_t>(library.arcs.size());
 }
 
-void read_cell(si2drGroupIdT cell, timing::library& library, boost::units::quantity<boost::units::si::time> time_unit, boost::units::quantity<boost::units::si::capacitance> capacitive_load_unit) {
+void read_cell(si2drGroupIdT cell, compiled_library& library, boost::units::quantity<boost::units::si::time> time_unit, boost::units::quantity<boost::units::si::capacitance> capacitive_load_unit) {
 
     si2drNamesIdT cell_names = si2drGroupGetNames(cell, &err);
     std::string name { si2drIterNextName(cell_names, &err) };
 
     si2drIterQuit(cell_names, &err);
 
-    auto cell_entity = library.cell_create(name);
+    const std::size_t cell_index = library.cells.size();
+    library.cells.push_back(cell_record{library.add_string(name), static_cast<std::uint32_t>(name.size()), 0, static_cast<std::uint32_t>(library.pins.size()), 0});
 
     si2drGroupsIdT groups = si2drGroupGetGroups(cell, &err);
     si2drGroupIdT current_cell_group;
@@ -336,11 +784,12 @@ void read_cell(si2drGroupIdT cell, timing::library& library, boost::units::quant
     while (!si2drObjectIsNull((current_cell_group = si2drIterNextGroup(groups, &err)), &err)) {
         std::string current_cell_group_type { si2drGroupGetGroupType(current_cell_group, &err) };
         if(current_cell_group_type == "ff")
-            library.cell_sequential(cell_entity, true);
+            library.cells[cell_index].sequential = 1;
         else if (current_cell_group_type == "pin") {
-            read_pin(cell_entity, current_cell_group, library, time_unit, capacitive_load_unit);
+            read_pin(current_cell_group, library, time_unit, capacitive_load_unit);
         }
     }
+    library.cells[cell_index].pins_end = static_cast<std::uint32_t>(library.pins.size());
 
     //    std::cout << "  flipflop: " << (cell_type.isSequential?"true":"false") << std::endl;
 
@@ -349,7 +798,9 @@ void read_cell(si2drGroupIdT cell, timing::library& library, boost::units::quant
 }
 }
 
-void read(std::string filename, timing::library& library) {
+namespace {
+
+void parse(const std::string & filename, compiled_library& library) {
     si2drPIInit(&err);
     si2drReadLibertyFile(const_cast<char*>(filename.c_str()), &err);
     if (err == SI2DR_INVALID_NAME) {
@@ -440,6 +891,37 @@ void read(std::string filename, timing::library& library) {
     si2drPIQuit(&err);
 }
 
+}
+
+void read(std::string filename, timing::library& library) {
+    compiled_library compiled;
+    parse(filename, compiled);
+    populate(compiled.view(), library);
+}
+
+void read(std::string filename, timing::library& library, std::string cache_filename) {
+    std::uint64_t source_size, source_hash;
+    {
+        mapped_file source(filename);
+        source_size = source.size();
+        source_hash = hash(source.data(), source.size());
+    }
+    try {
+        mapped_file cache(cache_filename);
+        library_view view;
+        if (map_cache(cache, source_size, source_hash, view)) {
+            populate(view, library);
+            return;
+        }
+    } catch (const std::runtime_error &) {
+        // no cache yet
+    }
+    compiled_library compiled;
+    parse(filename, compiled);
+    write_cache(cache_filename, compiled, source_size, source_hash);
+    populate(compiled.view(), library);
+}
+
 } /* namespace liberty */
 } /* namespace timing */
 } /* namespace ophidian */
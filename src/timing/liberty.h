@@ -30,6 +30,15 @@ namespace liberty {
 
 void read(std::string filename, timing::library& library);
 
+/// Reads the file through a binary cache of its parsed contents.
+/**
+ * The cache is mapped and loaded without parsing when it was written by the
+ * same cache version from a file with the same size and hash; otherwise the
+ * file is parsed and the cache is (re)written. The library gets the same
+ * cells, pins and arcs, created in the same order, as with read().
+ */
+void read(std::string filename, timing::library& library, std::string cache_filename);
+
 } /* namespace liberty */
 } /* namespace timing */
 } /* namespace ophidian */
@@ -25,25 +25,42 @@ under the License.
 #include <boost/units/systems/si.hpp>
 #include <boost/units/systems/si/prefixes.hpp>
 #include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
 
 namespace ophidian {
 namespace timing {
 
+/// Two dimensional lookup table with bilinear interpolation.
+/**
+ * Breakpoints are kept sorted in two vectors and the values are packed row by
+ * row in a single contiguous vector. The segment containing a point is found
+ * with a binary search, and a located point can be reused to interpolate many
+ * tables that share the same breakpoints.
+ */
 template<class RowType, class ColumnType, class ValueType>
 class lookup_table {
 	std::vector<RowType> m_row_values;
 	std::vector<ColumnType> m_column_values;
-	std::vector<std::vector<ValueType> > m_values;
+	std::vector<ValueType> m_values;
 public:
 
+	/// Segment and weights of a (row, column) point.
+	struct interpolation_point {
+		std::size_t row;
+		std::size_t column;
+		double row_weight;
+		double column_weight;
+	};
+
 	bool operator==(const lookup_table<RowType, ColumnType, ValueType> & lut) const
 	{
 		return (m_row_values == lut.m_row_values)&&(m_column_values==lut.m_column_values)&&(m_values==lut.m_values);
 	}
 
 	lookup_table(std::size_t rows=0, std::size_t columns=0) :
-			m_row_values(rows), m_column_values(columns), m_values(rows,
-					std::vector<ValueType>(columns)) {
+			m_row_values(rows), m_column_values(columns), m_values(rows*columns) {
 
 	}
 	virtual ~lookup_table() {
@@ -74,84 +91,116 @@ public:
 	}
 
 	ValueType at(std::size_t row, std::size_t column) const {
-		return m_values.at(row).at(column);
+		if(row >= row_count() || column >= column_count())
+			throw std::out_of_range("lookup_table::at");
+		return m_values[row*column_count()+column];
 	}
 
 	void at(std::size_t row, std::size_t column, ValueType value) {
-		if(row >= m_values.size() || column >= m_values.front().size())
-			std::cout << "ERROO!!!" << std::endl;
-		m_values.at(row).at(column) = value;
+		if(row >= row_count() || column >= column_count())
+			throw std::out_of_range("lookup_table::at");
+		m_values[row*column_count()+column] = value;
 	}
 
-	ValueType compute(RowType rv, ColumnType cv) const {
+	interpolation_point locate(RowType rv, ColumnType cv) const {
+		interpolation_point point{0, 0, 0.0, 0.0};
 
-		if (m_values.size() == 1)
-			if (m_values.front().size() == 1)
-				return m_values.front().front();
-
-		double wTransition, wLoad;
-		RowType y1, y2;
-
-		ColumnType x1, x2;
-		ValueType t[2][2];
-		std::size_t row1, row2, column1, column2;
-		wTransition = 0.0f;
-		wLoad = 0.0f;
-
-		row1 = m_row_values.size() - 2;
-		row2 = m_row_values.size() - 1;
-
-		y1 = m_row_values[row1];
-		y2 = m_row_values[row2];
-
-		// loads -- rows
-		for (size_t i = 0; i < m_row_values.size() - 1; i++) {
-			if (rv >= m_row_values[i] && rv <= m_row_values[i + 1]) {
-				row1 = i;
-				row2 = i + 1;
-				y1 = m_row_values[row1];
-				y2 = m_row_values[row2];
+		// loads -- rows. Out of the table the last segment is used on both sides
+		if (m_row_values.size() > 1) {
+			point.row = m_row_values.size() - 2;
+			if (rv >= m_row_values.front() && rv <= m_row_values.back()) {
+				std::size_t upper = std::upper_bound(m_row_values.begin(), m_row_values.end(), rv) - m_row_values.begin();
+				point.row = std::min(upper - 1, m_row_values.size() - 2);
 			}
+			const RowType y1 = m_row_values[point.row];
+			const RowType y2 = m_row_values[point.row + 1];
+			point.row_weight = (rv - y1) / (y2 - y1);
 		}
 
-		// transitions -- columns
-		if (cv < m_column_values[0]) {
-			column1 = 0;
-			column2 = 1;
-			x1 = m_column_values[column1];
-			x2 = m_column_values[column2];
-		} else if (cv
-				> m_column_values[m_column_values.size() - 1]) {
-			column1 = m_column_values.size() - 2;
-			column2 = m_column_values.size() - 1;
-			x1 = m_column_values[column1];
-			x2 = m_column_values[column2];
-		} else {
-			for (size_t i = 0; i < m_column_values.size() - 1; i++) {
-				if (cv >= m_column_values[i]
-						&& cv <= m_column_values[i + 1]) {
-					column1 = i;
-					column2 = i + 1;
-					x1 = m_column_values[column1];
-					x2 = m_column_values[column2];
-				}
+		// transitions -- columns. Out of the table the nearest segment is used
+		if (m_column_values.size() > 1) {
+			if (cv < m_column_values.front())
+				point.column = 0;
+			else if (cv > m_column_values.back())
+				point.column = m_column_values.size() - 2;
+			else {
+				std::size_t upper = std::upper_bound(m_column_values.begin(), m_column_values.end(), cv) - m_column_values.begin();
+				point.column = std::min(upper - 1, m_column_values.size() - 2);
 			}
+			const ColumnType x1 = m_column_values[point.column];
+			const ColumnType x2 = m_column_values[point.column + 1];
+			point.column_weight = (cv - x1) / (x2 - x1);
 		}
+		return point;
+	}
+
+	ValueType interpolate(const interpolation_point & point) const {
+		const std::size_t columns = m_column_values.size();
+		const std::size_t row1 = point.row;
+		const std::size_t row2 = std::min(point.row + 1, m_row_values.size() - 1);
+		const std::size_t column1 = point.column;
+		const std::size_t column2 = std::min(point.column + 1, columns - 1);
+		const double wTransition = point.column_weight;
+		const double wLoad = point.row_weight;
 
 		//equation for interpolation (Ref - ISPD Contest: http://www.ispd.cc/contests/12/ISPD_2012_Contest_Details.pdf), slide 17
-		wTransition = (cv - x1) / (x2 - x1);
-		wLoad = (rv - y1) / (y2 - y1);
+		return ValueType(((1 - wTransition) * (1 - wLoad) * m_values[row1*columns+column1])
+				+ (wTransition * (1 - wLoad) * m_values[row1*columns+column2])
+				+ ((1 - wTransition) * wLoad * m_values[row2*columns+column1])
+				+ (wTransition * wLoad * m_values[row2*columns+column2]));
+	}
+
+	ValueType compute(RowType rv, ColumnType cv) const {
+
+		if (m_values.size() == 1)
+			return m_values.front();
 
-		t[0][0] = m_values[row1][column1];
-		t[0][1] = m_values[row1][column2];
-		t[1][0] = m_values[row2][column1];
-		t[1][1] = m_values[row2][column2];
+		return interpolate(locate(rv, cv));
+	}
 
-		return boost::units::quantity<boost::units::si::time>(((1 - wTransition) * (1 - wLoad) * t[0][0])
-				+ (wTransition * (1 - wLoad) * t[0][1])
-				+ ((1 - wTransition) * wLoad * t[1][0])
-				+ (wTransition * wLoad * t[1][1]));
+	/// Interpolates count (row, column) pairs against this table.
+	/**
+	 * The segments are searched first for a block of points, then the block is
+	 * interpolated in a loop the compiler can vectorize. Results are the same
+	 * as calling compute() for each pair.
+	 */
+	void compute(const RowType * rvs, const ColumnType * cvs, std::size_t count, ValueType * results) const {
+		if (m_values.size() == 1) {
+			std::fill(results, results + count, m_values.front());
+			return;
+		}
 
+		const std::size_t columns = m_column_values.size();
+		const std::size_t last_row = m_row_values.size() - 1;
+		const std::size_t last_column = columns - 1;
+		const std::size_t block_size = 64;
+		std::size_t offsets[block_size][4];
+		double row_weights[block_size];
+		double column_weights[block_size];
+		for (std::size_t begin = 0; begin < count; begin += block_size) {
+			const std::size_t size = std::min(block_size, count - begin);
+			for (std::size_t i = 0; i < size; ++i) {
+				const interpolation_point point = locate(rvs[begin + i], cvs[begin + i]);
+				const std::size_t row2 = std::min(point.row + 1, last_row);
+				const std::size_t column2 = std::min(point.column + 1, last_column);
+				offsets[i][0] = point.row*columns + point.column;
+				offsets[i][1] = point.row*columns + column2;
+				offsets[i][2] = row2*columns + point.column;
+				offsets[i][3] = row2*columns + column2;
+				row_weights[i] = point.row_weight;
+				column_weights[i] = point.column_weight;
+			}
+			ValueType * block_results = results + begin;
+#pragma omp simd
+			for (std::size_t i = 0; i < size; ++i) {
+				const double wTransition = column_weights[i];
+				const double wLoad = row_weights[i];
+				block_results[i] = ValueType(((1 - wTransition) * (1 - wLoad) * m_values[offsets[i][0]])
+						+ (wTransition * (1 - wLoad) * m_values[offsets[i][1]])
+						+ ((1 - wTransition) * wLoad * m_values[offsets[i][2]])
+						+ (wTransition * wLoad * m_values[offsets[i][3]]));
+			}
+		}
 	}
 
 };
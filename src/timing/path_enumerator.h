@@ -0,0 +1,250 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+
+#ifndef OPHIDIAN_TIMING_PATH_ENUMERATOR_H
+#define OPHIDIAN_TIMING_PATH_ENUMERATOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <set>
+
+#include "generic_sta.h"
+
+namespace ophidian {
+namespace timing {
+
+// a path from a startpoint to an endpoint, nodes and arcs in propagation order
+struct timing_path {
+    boost::units::quantity< boost::units::si::time > slack;
+    std::vector<graph::node> nodes;
+    std::vector<graph::edge> arcs;
+};
+
+/// Enumerates the worst paths of a propagated corner in order of slack.
+/**
+ * The worst path of an endpoint follows, from the endpoint backwards, the arc
+ * that gives each node its arrival. Any other path of the endpoint leaves it at
+ * some arcs (deviations), and each deviation costs the difference between the
+ * arrival of its node and the arrival through the arc, so the slack of a path is
+ * the slack of its endpoint plus the cost of its deviations. Paths are generated
+ * lazily from a heap of deviations: popping a path adds, as its children, the
+ * deviations at the nodes after its last one. The heap never keeps more
+ * candidates than the paths still missing, so memory is O(k) besides the
+ * worst arc of each node, which is found once at construction.
+ * From: Eppstein, David. "Finding the k shortest paths." SIAM Journal on Computing 28.2 (1998).
+ **/
+template <class MergeStrategy>
+class path_enumerator
+{
+    using SlewType = boost::units::quantity< boost::units::si::time >;
+    static const csr_graph::index npos = std::numeric_limits<csr_graph::index>::max();
+    static const std::size_t no_parent = std::numeric_limits<std::size_t>::max();
+
+    // a path, given by its endpoint, its last deviation arc and the path it deviates from
+    struct candidate {
+        SlewType slack;
+        std::size_t parent; // index in the popped paths, no_parent for the worst path of the endpoint
+        csr_graph::index arc;
+        csr_graph::index endpoint;
+        bool operator<(const candidate & o) const {
+            return slack < o.slack;
+        }
+    };
+
+    const csr_graph & m_graph;
+    const timing_data & m_timing;
+    std::vector<csr_graph::index> m_worst_arcs; // npos for startpoints
+    std::vector<SlewType> m_arrivals; // through the worst arc
+
+    SlewType arrival_through(csr_graph::index arc) const {
+        return m_timing.nodes.arrival(m_graph.node(m_graph.source(arc))) + m_timing.arcs.delay(m_graph.arc(arc));
+    }
+
+    SlewType endpoint_slack(csr_graph::index node) const {
+        const graph::node n = m_graph.node(node);
+        return MergeStrategy::slack_signal()*(m_timing.nodes.required(n)-m_timing.nodes.arrival(n));
+    }
+
+    static void push(std::multiset<candidate> & heap, const candidate & c, std::size_t capacity) {
+        if(heap.size() == capacity)
+        {
+            if(capacity == 0 || !(c < *std::prev(heap.end())))
+                return;
+            heap.erase(std::prev(heap.end()));
+        }
+        heap.insert(c);
+    }
+
+    // pops the k worst paths of the roots, in order
+    std::vector<candidate> enumerate(const std::vector<candidate> & roots, std::size_t k) const {
+        std::multiset<candidate> heap;
+        for(auto & root : roots)
+            push(heap, root, k);
+
+        std::vector<candidate> popped;
+        popped.reserve(std::min(k, roots.size()));
+        while(!heap.empty() && popped.size() < k)
+        {
+            const std::size_t current = popped.size();
+            popped.push_back(*heap.begin());
+            heap.erase(heap.begin());
+            const std::size_t missing = k - popped.size();
+            const candidate path = popped[current];
+
+            // deviations at the nodes after the last one of the popped path
+            csr_graph::index node = path.arc == npos ? path.endpoint : m_graph.source(path.arc);
+            while(node != npos && missing > 0)
+            {
+                const csr_graph::index worst = m_worst_arcs[node];
+                for(auto it = m_graph.in_arcs_begin(node); it != m_graph.in_arcs_end(node); ++it)
+                {
+                    if(*it == worst)
+                        continue;
+                    const SlewType cost = MergeStrategy::slack_signal()*(m_arrivals[node]-arrival_through(*it));
+                    if(std::isfinite(cost.value()))
+                        push(heap, candidate{path.slack + cost, current, *it, path.endpoint}, missing);
+                }
+                node = worst == npos ? npos : m_graph.source(worst);
+            }
+        }
+        return popped;
+    }
+
+    timing_path build(const std::vector<candidate> & popped, std::size_t path) const {
+        std::vector<csr_graph::index> deviations;
+        for(std::size_t p = path; popped[p].parent != no_parent; p = popped[p].parent)
+            deviations.push_back(popped[p].arc);
+
+        timing_path result;
+        result.slack = popped[path].slack;
+        csr_graph::index node = popped[path].endpoint;
+        result.nodes.push_back(m_graph.node(node));
+        while(true)
+        {
+            csr_graph::index arc = m_worst_arcs[node];
+            if(!deviations.empty() && m_graph.target(deviations.back()) == node)
+            {
+                arc = deviations.back();
+                deviations.pop_back();
+            }
+            if(arc == npos)
+                break;
+            node = m_graph.source(arc);
+            result.arcs.push_back(m_graph.arc(arc));
+            result.nodes.push_back(m_graph.node(node));
+        }
+        std::reverse(result.nodes.begin(), result.nodes.end());
+        std::reverse(result.arcs.begin(), result.arcs.end());
+        return result;
+    }
+
+    std::vector<timing_path> build(const std::vector<candidate> & popped) const {
+        std::vector<timing_path> paths(popped.size());
+        std::size_t i;
+#pragma omp parallel for schedule(dynamic, 16) if(popped.size() > 64)
+        for(i = 0; i < popped.size(); ++i)
+            paths[i] = build(popped, i);
+        return paths;
+    }
+
+    bool root(csr_graph::index endpoint, candidate & c) const {
+        c = candidate{endpoint_slack(endpoint), no_parent, npos, endpoint};
+        return std::isfinite(c.slack.value());
+    }
+
+public:
+    path_enumerator(const graph_and_topology & topology, const timing_data & timing) :
+        m_graph(topology.csr),
+        m_timing(timing),
+        m_worst_arcs(m_graph.node_count(), npos),
+        m_arrivals(m_graph.node_count())
+    {
+        MergeStrategy merge;
+        std::size_t i;
+#pragma omp parallel for schedule(dynamic, 1024)
+        for(i = 0; i < m_graph.node_count(); ++i)
+        {
+            const csr_graph::index node = static_cast<csr_graph::index>(i);
+            SlewType arrival = MergeStrategy::best();
+            for(auto it = m_graph.in_arcs_begin(node); it != m_graph.in_arcs_end(node); ++it)
+            {
+                const SlewType current = arrival_through(*it);
+                if(m_worst_arcs[node] == npos || merge(arrival, current) != arrival)
+                {
+                    m_worst_arcs[node] = *it;
+                    arrival = current;
+                }
+            }
+            m_arrivals[node] = arrival;
+        }
+    }
+
+    /// The k worst paths ending at the endpoint node, worst first.
+    std::vector<timing_path> endpoint_paths(graph::node endpoint, std::size_t k) const {
+        candidate c;
+        if(!root(m_graph.node_index(endpoint), c))
+            return std::vector<timing_path>();
+        return build(enumerate(std::vector<candidate>{c}, k));
+    }
+
+    /// The k worst paths of each endpoint, enumerated in parallel.
+    std::vector< std::vector<timing_path> > endpoint_paths(const std::vector<graph::node> & endpoints, std::size_t k) const {
+        std::vector< std::vector<timing_path> > paths(endpoints.size());
+        std::size_t i;
+#pragma omp parallel for schedule(dynamic, 1)
+        for(i = 0; i < endpoints.size(); ++i)
+        {
+            candidate c;
+            if(root(m_graph.node_index(endpoints[i]), c))
+            {
+                const std::vector<candidate> popped = enumerate(std::vector<candidate>{c}, k);
+                for(std::size_t p = 0; p < popped.size(); ++p)
+                    paths[i].push_back(build(popped, p));
+            }
+        }
+        return paths;
+    }
+
+    /// The k worst paths of the design, worst first. Every endpoint starts in
+    /// the same heap, so the enumeration stays O(k) however many endpoints fail.
+    std::vector<timing_path> worst_paths(std::size_t k) const {
+        std::vector<candidate> roots;
+        for(std::size_t i = 0; i < m_graph.node_count(); ++i)
+        {
+            candidate c;
+            if(m_graph.out_degree(i) == 0 && root(static_cast<csr_graph::index>(i), c))
+                roots.push_back(c);
+        }
+        return build(enumerate(roots, k));
+    }
+};
+
+template <class MergeStrategy>
+const csr_graph::index path_enumerator<MergeStrategy>::npos;
+template <class MergeStrategy>
+const std::size_t path_enumerator<MergeStrategy>::no_parent;
+
+}
+}
+
+#endif // OPHIDIAN_TIMING_PATH_ENUMERATOR_H
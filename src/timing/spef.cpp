@@ -21,9 +21,20 @@ under the License.
 #include "spef.h"
 
 #include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <boost/units/systems/si.hpp>
 #include <boost/units/systems/si/prefixes.hpp>
+#include <boost/utility/string_ref.hpp>
 
 using namespace boost::units;
 using namespace boost::units::si;
@@ -31,6 +42,229 @@ using namespace boost::units::si;
 namespace ophidian {
 namespace timing {
 
+namespace {
+
+using token = boost::string_ref;
+
+struct token_hash {
+    std::size_t operator()(const token & t) const {
+        std::size_t hash = 14695981039346656037ULL;
+        for(char c : t)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+};
+
+bool is_space(char c)
+{
+    return std::isspace(static_cast<unsigned char>(c));
+}
+
+// splits the line starting at begin into tokens and returns the start of the next line
+const char * tokenize_line(const char * begin, const char * end, std::vector<token> & tokens)
+{
+    tokens.resize(0);
+    const char * it = begin;
+    while(it != end && *it != '\n')
+    {
+        if(is_space(*it))
+        {
+            ++it;
+            continue;
+        }
+        const char * token_begin = it;
+        while(it != end && !is_space(*it))
+            ++it;
+        tokens.push_back(token(token_begin, it - token_begin));
+    }
+    return it == end ? end : it + 1;
+}
+
+double to_double(token t)
+{
+    char buffer[64];
+    const std::size_t size = std::min(t.size(), sizeof(buffer)-1);
+    std::memcpy(buffer, t.data(), size);
+    buffer[size] = '\0';
+    return std::strtod(buffer, nullptr);
+}
+
+// Parses one *D_NET ... *END block. Node names are views into the mapped
+// file, only the net name, the source and the taps are copied.
+class packed_net_parser {
+    struct resistor {
+        std::size_t u, v;
+        double value;
+    };
+
+    std::unordered_map<token, std::size_t, token_hash> m_index;
+    std::vector<token> m_names;
+    std::vector<double> m_capacitances;
+    std::vector<resistor> m_resistors;
+    std::vector<std::size_t> m_sinks;
+    std::vector<token> m_tokens;
+    std::vector<std::size_t> m_adjacency_begin;
+    std::vector<std::size_t> m_adjacency;
+    std::vector<std::size_t> m_order;
+    std::vector<std::size_t> m_queue;
+    std::vector<std::size_t> m_parent; // resistor to the parent, by node
+
+    std::size_t node(token name) {
+        auto result = m_index.insert(std::make_pair(name, m_names.size()));
+        if(result.second)
+        {
+            m_names.push_back(name);
+            m_capacitances.push_back(0.0);
+        }
+        return result.first->second;
+    }
+
+    void clear() {
+        m_index.clear();
+        m_names.resize(0);
+        m_capacitances.resize(0);
+        m_resistors.resize(0);
+        m_sinks.resize(0);
+    }
+
+    void pack(std::size_t source, packed_spef_tree & result) {
+        const std::size_t node_count = m_names.size();
+        m_adjacency_begin.assign(node_count+1, 0);
+        for(auto & r : m_resistors)
+        {
+            ++m_adjacency_begin[r.u+1];
+            ++m_adjacency_begin[r.v+1];
+        }
+        for(std::size_t i = 0; i < node_count; ++i)
+            m_adjacency_begin[i+1] += m_adjacency_begin[i];
+        m_adjacency.resize(2*m_resistors.size());
+        m_queue.assign(m_adjacency_begin.begin(), m_adjacency_begin.end()-1); // insertion cursors
+        for(std::size_t i = 0; i < m_resistors.size(); ++i)
+        {
+            m_adjacency[m_queue[m_resistors[i].u]++] = i;
+            m_adjacency[m_queue[m_resistors[i].v]++] = i;
+        }
+
+        // breadth-first from the source, as rc_tree::pack(); nodes not
+        // connected to the source are left out
+        const std::size_t unvisited = std::numeric_limits<std::size_t>::max();
+        m_order.assign(node_count, unvisited);
+        m_parent.assign(node_count, unvisited);
+        m_queue.resize(0);
+        m_queue.push_back(source);
+        m_order[source] = 0;
+        for(std::size_t head = 0; head < m_queue.size(); ++head)
+        {
+            const std::size_t current = m_queue[head];
+            for(std::size_t a = m_adjacency_begin[current]; a < m_adjacency_begin[current+1]; ++a)
+            {
+                const resistor & r = m_resistors[m_adjacency[a]];
+                const std::size_t target = r.u == current ? r.v : r.u;
+                if(m_order[target] != unvisited)
+                    continue;
+                m_order[target] = m_queue.size();
+                m_parent[target] = m_adjacency[a];
+                m_queue.push_back(target);
+            }
+        }
+
+        result.tree = interconnection::packed_rc_tree(m_queue.size());
+        result.tree.pred(0, std::numeric_limits<std::size_t>::max());
+        for(std::size_t i = 0; i < m_queue.size(); ++i)
+        {
+            const std::size_t current = m_queue[i];
+            result.tree.capacitance(i, quantity<si::capacitance>(m_capacitances[current]*femto*farads));
+            if(i > 0)
+            {
+                const resistor & r = m_resistors[m_parent[current]];
+                result.tree.pred(i, m_order[r.u == current ? r.v : r.u]);
+                result.tree.resistance(i, quantity<si::resistance>(r.value*kilo*ohms));
+            }
+        }
+        for(auto sink : m_sinks)
+        {
+            if(m_order[sink] != unvisited)
+                result.tree.tap(m_names[sink].to_string(), m_order[sink]);
+        }
+    }
+
+public:
+    void parse(const char * begin, const char * end, packed_spef_tree & result) {
+        enum section {
+            NONE, CONN, CAP, RES
+        };
+        clear();
+        section current = NONE;
+        std::size_t source = std::numeric_limits<std::size_t>::max();
+        const char * line = begin;
+        while(line != end)
+        {
+            line = tokenize_line(line, end, m_tokens);
+            if(m_tokens.empty())
+                continue;
+            const token & first = m_tokens.front();
+            if(first == "*D_NET" && m_tokens.size() > 1)
+                result.net_name = m_tokens[1].to_string();
+            else if(first == "*CONN")
+                current = CONN;
+            else if(first == "*CAP")
+                current = CAP;
+            else if(first == "*RES")
+                current = RES;
+            else if(first == "*END")
+                break;
+            else if(current == CONN && m_tokens.size() >= 3 && (first == "*I" || first == "*P"))
+            {
+                auto pin = node(m_tokens[1]);
+                if((first == "*I" && m_tokens[2] == "O") || (first == "*P" && m_tokens[2] == "I"))
+                    source = pin;
+                else
+                    m_sinks.push_back(pin);
+            }
+            else if(current == CAP && m_tokens.size() == 3)
+                m_capacitances[node(m_tokens[1])] = to_double(m_tokens[2]);
+            else if(current == RES && m_tokens.size() == 4)
+            {
+                const std::size_t u = node(m_tokens[1]);
+                const std::size_t v = node(m_tokens[2]);
+                m_resistors.push_back(resistor{u, v, to_double(m_tokens[3])});
+            }
+        }
+        if(m_names.empty())
+            return;
+        if(source == std::numeric_limits<std::size_t>::max())
+            source = 0;
+        result.source = m_names[source].to_string();
+        pack(source, result);
+    }
+};
+
+// offsets of the lines starting with *D_NET
+std::vector<std::size_t> index_nets(const char * data, std::size_t size)
+{
+    static const char keyword[] = "*D_NET";
+    const std::size_t keyword_size = sizeof(keyword)-1;
+    std::vector<std::size_t> offsets;
+    std::size_t i = 0;
+    while(i < size)
+    {
+        while(i < size && data[i] != '\n' && is_space(data[i]))
+            ++i;
+        if(size - i >= keyword_size && std::memcmp(data+i, keyword, keyword_size) == 0)
+            offsets.push_back(i);
+        const void * newline = std::memchr(data+i, '\n', size-i);
+        if(!newline)
+            break;
+        i = static_cast<const char*>(newline) - data + 1;
+    }
+    return offsets;
+}
+
+}
+
 void spef::tokenize(const std::string &line, std::vector<std::string> &tokens)
 {
     tokens.resize(0);
@@ -171,6 +405,55 @@ void spef::read(const std::string &in)
     return read(in_file);
 }
 
+void spef::read_packed(const std::string &filename)
+{
+    int file = open(filename.c_str(), O_RDONLY);
+    if(file < 0)
+        throw std::runtime_error("spef: cannot open " + filename);
+    struct stat status;
+    if(fstat(file, &status) != 0)
+    {
+        close(file);
+        throw std::runtime_error("spef: cannot stat " + filename);
+    }
+    const std::size_t size = static_cast<std::size_t>(status.st_size);
+    if(size == 0)
+    {
+        close(file);
+        m_packed_trees.clear();
+        return;
+    }
+    void * data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if(data == MAP_FAILED)
+        throw std::runtime_error("spef: cannot map " + filename);
+    try {
+        read_packed(static_cast<const char*>(data), size);
+    } catch(...) {
+        munmap(data, size);
+        throw;
+    }
+    munmap(data, size);
+}
+
+void spef::read_packed(const char *data, std::size_t size)
+{
+    const std::vector<std::size_t> offsets = index_nets(data, size);
+    m_packed_trees.clear();
+    m_packed_trees.resize(offsets.size());
+#pragma omp parallel
+    {
+        packed_net_parser parser;
+        std::size_t i;
+#pragma omp for schedule(dynamic, 64)
+        for(i = 0; i < offsets.size(); ++i)
+        {
+            const std::size_t end = i+1 < offsets.size() ? offsets[i+1] : size;
+            parser.parse(data+offsets[i], data+end, m_packed_trees[i]);
+        }
+    }
+}
+
 void spef::read(std::istream &in)
 {
     std::string line;
@@ -32,10 +32,17 @@ struct spef_tree {
     std::string source;
 };
 
+struct packed_spef_tree {
+    std::string net_name;
+    interconnection::packed_rc_tree tree; // packed from the source, sinks tapped by name
+    std::string source;
+};
+
 class spef
 {
 public:
     std::vector<spef_tree> m_trees;
+    std::vector<packed_spef_tree> m_packed_trees;
 
     void tokenize(const std::string & line, std::vector<std::string> & tokens);
 
@@ -52,9 +59,18 @@ public:
     void read(const std::string & in);
     void read(std::istream & in);
 
+    // Memory maps the file, splits it at the *D_NET lines and parses the nets
+    // in parallel straight into packed trees, without building rc_trees.
+    void read_packed(const std::string & filename);
+    void read_packed(const char * data, std::size_t size);
+
     const std::vector<spef_tree> & trees() const {
         return m_trees;
     }
+
+    const std::vector<packed_spef_tree> & packed_trees() const {
+        return m_packed_trees;
+    }
 };
 
 }
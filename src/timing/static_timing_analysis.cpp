@@ -21,20 +21,38 @@ under the License.
 #include "static_timing_analysis.h"
 #include "graph_builder.h"
 
-#include "wns.h"
+#include <algorithm>
+#include <limits>
 
 namespace ophidian {
 namespace timing {
 
 void static_timing_analysis::init_timing_data()
 {
-    m_late.reset(new timing::timing_data(*m_late_lib, *m_timing_graph));
-    m_early.reset(new timing::timing_data(*m_early_lib, *m_timing_graph));
-    m_topology.reset(new timing::graph_and_topology(*m_timing_graph, *m_netlist, *m_late_lib));
-    m_late_sta.reset(new timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic>(*m_late, *m_topology, *m_rc_trees));
-    m_early_sta.reset(new timing::generic_sta<timing::effective_capacitance_wire_model, timing::optimistic>(*m_early, *m_topology, *m_rc_trees));
-    m_test.reset(new timing::test_calculator{*m_topology, *m_early, *m_late, TimeType(m_dc.clock.period*boost::units::si::pico*boost::units::si::seconds)});
+    using namespace boost::units;
+    m_late.clear();
+    m_early.clear();
+    m_tests.clear();
+    std::vector<timing_data*> late_corners, early_corners;
+    for(auto & c : m_corners)
+    {
+        m_late.push_back(std::unique_ptr<timing_data>(new timing::timing_data(*c.late_lib, *m_timing_graph)));
+        m_early.push_back(std::unique_ptr<timing_data>(new timing::timing_data(*c.early_lib, *m_timing_graph)));
+        late_corners.push_back(m_late.back().get());
+        early_corners.push_back(m_early.back().get());
+    }
+    m_topology.reset(new timing::graph_and_topology(*m_timing_graph, *m_netlist, *m_corners.front().late_lib));
+    m_late_sta.reset(new timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic>(late_corners, *m_topology, *m_rc_trees));
+    m_early_sta.reset(new timing::generic_sta<timing::effective_capacitance_wire_model, timing::optimistic>(early_corners, *m_topology, *m_rc_trees));
+    for(std::size_t i = 0; i < m_corners.size(); ++i)
+        m_tests.push_back(timing::test_calculator{*m_topology, *m_early[i], *m_late[i], TimeType(m_corners[i].dc.clock.period*si::pico*si::seconds)});
     m_endpoints = timing::endpoints(*m_netlist);
+    m_endpoint_index.assign(m_netlist->pin_system().size(), std::numeric_limits<std::size_t>::max());
+    std::size_t position = 0;
+    for(auto pin : m_endpoints)
+        m_endpoint_index[m_netlist->pin_system().lookup(pin)] = position++;
+    m_late_slacks.assign(m_corners.size(), endpoint_slacks());
+    m_early_slacks.assign(m_corners.size(), endpoint_slacks());
 }
 
 void static_timing_analysis::propagate_ats()
@@ -49,15 +67,80 @@ void static_timing_analysis::propagate_rts()
     m_early_sta->update_rts();
 }
 
+void static_timing_analysis::compute_tests()
+{
+    for(auto & test : m_tests)
+        test.compute_tests();
+}
+
+std::vector<std::size_t> static_timing_analysis::updated_tests() const
+{
+    const csr_graph & G = m_topology->csr;
+    const std::vector<std::size_t> & begin = m_topology->node_tests_begin;
+    std::vector<std::size_t> tests;
+    for(auto drivers : {&m_late_sta->updated_drivers(), &m_early_sta->updated_drivers()})
+    {
+        for(auto driver : *drivers)
+        {
+            for(auto a = G.out_arcs_begin(driver); a != G.out_arcs_end(driver); ++a)
+            {
+                const csr_graph::index sink = G.target(a);
+                tests.insert(tests.end(), m_topology->node_tests.begin()+begin[sink], m_topology->node_tests.begin()+begin[sink+1]);
+            }
+        }
+    }
+    std::sort(tests.begin(), tests.end());
+    tests.erase(std::unique(tests.begin(), tests.end()), tests.end());
+    return tests;
+}
+
 void static_timing_analysis::update_wns_and_tns()
 {
-    m_lwns = timing::wns(m_endpoints, *m_late_sta).value();
-    m_ewns = timing::wns(m_endpoints, *m_early_sta).value();
+    const std::vector<entity_system::entity> pins(m_endpoints.begin(), m_endpoints.end());
+    std::vector<TimeType> late(pins.size()), early(pins.size());
+    for(std::size_t c = 0; c < m_corners.size(); ++c)
+    {
+        std::size_t i;
+#pragma omp parallel for
+        for(i = 0; i < pins.size(); ++i)
+        {
+            late[i] = std::min(m_late_sta->rise_slack(pins[i], c), m_late_sta->fall_slack(pins[i], c));
+            early[i] = std::min(m_early_sta->rise_slack(pins[i], c), m_early_sta->fall_slack(pins[i], c));
+        }
+        m_late_slacks[c].assign(late);
+        m_early_slacks[c].assign(early);
+    }
+}
+
+void static_timing_analysis::update_wns_and_tns(const std::vector<csr_graph::index> &late_sinks, const std::vector<csr_graph::index> &early_sinks)
+{
+    for(auto node : late_sinks)
+    {
+        const entity_system::entity pin = m_topology->csr.pin(node);
+        const std::size_t endpoint = m_endpoint_index[m_netlist->pin_system().lookup(pin)];
+        if(endpoint == std::numeric_limits<std::size_t>::max())
+            continue;
+        for(std::size_t c = 0; c < m_corners.size(); ++c)
+            m_late_slacks[c].update(endpoint, std::min(m_late_sta->rise_slack(pin, c), m_late_sta->fall_slack(pin, c)));
+    }
+    for(auto node : early_sinks)
+    {
+        const entity_system::entity pin = m_topology->csr.pin(node);
+        const std::size_t endpoint = m_endpoint_index[m_netlist->pin_system().lookup(pin)];
+        if(endpoint == std::numeric_limits<std::size_t>::max())
+            continue;
+        for(std::size_t c = 0; c < m_corners.size(); ++c)
+            m_early_slacks[c].update(endpoint, std::min(m_early_sta->rise_slack(pin, c), m_early_sta->fall_slack(pin, c)));
+    }
 }
 
 static_timing_analysis::static_timing_analysis() :
     m_timing_graph(nullptr),
-    m_rc_trees(nullptr)
+    m_rc_trees(nullptr),
+    m_netlist(nullptr),
+    m_corners(1, corner{nullptr, nullptr, design_constraints()}),
+    m_late_slacks(1),
+    m_early_slacks(1)
 {
 
 }
@@ -69,13 +152,44 @@ void static_timing_analysis::update_timing()
 
     propagate_ats();
 
-    m_test->compute_tests();
+    compute_tests();
 
     propagate_rts();
 
     update_wns_and_tns();
 }
 
+void static_timing_analysis::update_timing(const std::vector<Net> &dirty_nets)
+{
+    if(!has_timing_data())
+    {
+        update_timing();
+        return;
+    }
+
+    m_late_sta->incremental_update_ats(dirty_nets);
+    m_early_sta->incremental_update_ats(dirty_nets);
+
+    const std::vector<std::size_t> tests = updated_tests();
+    for(auto & test : m_tests)
+        test.compute_tests(tests);
+
+    m_late_sta->incremental_update_rts(tests);
+    m_early_sta->incremental_update_rts(tests);
+
+    update_wns_and_tns(m_late_sta->updated_sinks(), m_early_sta->updated_sinks());
+}
+
+std::size_t static_timing_analysis::add_corner(const library &late, const library &early, const design_constraints &dc)
+{
+    m_corners.push_back(corner{&late, &early, dc});
+    m_late_slacks.push_back(endpoint_slacks());
+    m_early_slacks.push_back(endpoint_slacks());
+    m_late_sta.reset();
+    m_early_sta.reset();
+    return m_corners.size()-1;
+}
+
 
 void static_timing_analysis::graph(const ophidian::timing::graph &g)
 {
@@ -89,12 +203,12 @@ void static_timing_analysis::rc_trees(const entity_system::vector_property<inter
 
 void static_timing_analysis::late_lib(const library &lib)
 {
-    m_late_lib = &lib;
+    m_corners.front().late_lib = &lib;
 }
 
 void static_timing_analysis::early_lib(const library &lib)
 {
-    m_early_lib = &lib;
+    m_corners.front().early_lib = &lib;
 }
 
 void static_timing_analysis::netlist(const netlist::netlist &netlist)
@@ -104,7 +218,19 @@ void static_timing_analysis::netlist(const netlist::netlist &netlist)
 
 void static_timing_analysis::set_constraints(const design_constraints &dc)
 {
-    m_dc = dc;
+    m_corners.front().dc = dc;
+}
+
+std::vector<timing_path> static_timing_analysis::late_worst_paths(std::size_t k, std::size_t corner) const
+{
+    assert(has_timing_data());
+    return path_enumerator<pessimistic>(*m_topology, *m_late.at(corner)).worst_paths(k);
+}
+
+std::vector<timing_path> static_timing_analysis::early_worst_paths(std::size_t k, std::size_t corner) const
+{
+    assert(has_timing_data());
+    return path_enumerator<optimistic>(*m_topology, *m_early.at(corner)).worst_paths(k);
 }
 
 }
@@ -22,7 +22,9 @@ under the License.
 #define OPHIDIAN_TIMING_STATIC_TIMING_ANALYSIS_H
 
 #include "generic_sta.h"
+#include "path_enumerator.h"
 #include "endpoints.h"
+#include "endpoint_slacks.h"
 
 
 namespace ophidian {
@@ -38,35 +40,45 @@ using Pin = entity_system::entity;
 
 class static_timing_analysis
 {
+public:
+    // a library corner: the libraries and constraints of one signoff condition
+    struct corner {
+        const library * late_lib;
+        const library * early_lib;
+        design_constraints dc;
+    };
+private:
     const timing::graph * m_timing_graph;
     const entity_system::vector_property< interconnection::packed_rc_tree > * m_rc_trees;
-    const library * m_late_lib;
-    const library * m_early_lib;
     const netlist::netlist * m_netlist;
-    design_constraints m_dc;
+    std::vector<corner> m_corners; // the first corner is the one set by late_lib(), early_lib() and set_constraints()
 
 
     // lazy pointers
-    std::unique_ptr<timing_data> m_late;
-    std::unique_ptr<timing_data> m_early;
+    std::vector< std::unique_ptr<timing_data> > m_late;
+    std::vector< std::unique_ptr<timing_data> > m_early;
     std::unique_ptr<graph_and_topology> m_topology;
     std::unique_ptr<generic_sta<effective_capacitance_wire_model, pessimistic> > m_late_sta;
     std::unique_ptr<generic_sta<effective_capacitance_wire_model, optimistic> > m_early_sta;
-    std::unique_ptr<test_calculator> m_test;
+    std::vector<test_calculator> m_tests;
     endpoints m_endpoints;
-    TimeType m_lwns;
-    TimeType m_ewns;
-    TimeType m_ltns;
-    TimeType m_etns;
+    std::vector<std::size_t> m_endpoint_index; // position in m_endpoints by pin index, npos for other pins
+    std::vector<endpoint_slacks> m_late_slacks; // one per corner, empty until the first update_timing()
+    std::vector<endpoint_slacks> m_early_slacks;
 
     void init_timing_data();
     void propagate_ats();
     void propagate_rts();
+    void compute_tests();
+    // tests reading a sink of the drivers recomputed by the last incremental propagation, sorted
+    std::vector<std::size_t> updated_tests() const;
     void update_wns_and_tns();
+    // refreshes only the endpoints among the sinks updated by the last incremental propagation
+    void update_wns_and_tns(const std::vector<csr_graph::index> & late_sinks, const std::vector<csr_graph::index> & early_sinks);
     bool has_timing_data() const {
         assert(m_rc_trees);
         assert(m_timing_graph);
-        assert(m_late_lib && m_early_lib);
+        assert(m_corners.front().late_lib && m_corners.front().early_lib);
         assert(m_netlist);
         return m_late_sta && m_early_sta;
     }
@@ -79,60 +91,88 @@ public:
     void netlist(const netlist::netlist & netlist);
     void set_constraints(const design_constraints & dc);
 
+    // adds a corner propagated together with the others; returns its index
+    std::size_t add_corner(const library & late, const library & early, const design_constraints & dc);
+    std::size_t corner_count() const {
+        return m_corners.size();
+    }
+
     void update_timing();
+    // propagates only the timing affected by the rc trees of the given nets
+    void update_timing(const std::vector<Net> & dirty_nets);
 
 
-    TimeType late_wns() const {
-        return m_lwns;
+    TimeType late_wns(std::size_t corner = 0) const {
+        return m_late_slacks[corner].worst();
+    }
+    TimeType early_wns(std::size_t corner = 0) const{
+        return m_early_slacks[corner].worst();
+    }
+    TimeType late_tns(std::size_t corner = 0) const {
+        return m_late_slacks[corner].total_negative();
     }
-    TimeType early_wns() const{
-        return m_ewns;
+    TimeType early_tns(std::size_t corner = 0) const{
+        return m_early_slacks[corner].total_negative();
     }
-    TimeType late_tns() const {
-        return m_ltns;
+
+    // worst slack of each endpoint, in the order of timing_endpoints()
+    const endpoint_slacks & late_endpoint_slacks(std::size_t corner = 0) const {
+        return m_late_slacks[corner];
     }
-    TimeType early_tns() const{
-        return m_etns;
+    const endpoint_slacks & early_endpoint_slacks(std::size_t corner = 0) const {
+        return m_early_slacks[corner];
     }
 
-    TimeType early_rise_slack(Pin p) const {
-        return m_early_sta->rise_slack(p);
+    TimeType early_rise_slack(Pin p, std::size_t corner = 0) const {
+        return m_early_sta->rise_slack(p, corner);
     }
-    TimeType early_fall_slack(Pin p) const {
-        return m_early_sta->fall_slack(p);
+    TimeType early_fall_slack(Pin p, std::size_t corner = 0) const {
+        return m_early_sta->fall_slack(p, corner);
     }
-    TimeType late_rise_slack(Pin p) const {
-        return m_late_sta->rise_slack(p);
+    TimeType late_rise_slack(Pin p, std::size_t corner = 0) const {
+        return m_late_sta->rise_slack(p, corner);
     }
-    TimeType late_fall_slack(Pin p) const {
-        return m_late_sta->fall_slack(p);
+    TimeType late_fall_slack(Pin p, std::size_t corner = 0) const {
+        return m_late_sta->fall_slack(p, corner);
     }
 
-    TimeType early_rise_arrival(Pin p) const {
-        return m_early_sta->rise_arrival(p);
+    TimeType early_rise_arrival(Pin p, std::size_t corner = 0) const {
+        return m_early_sta->rise_arrival(p, corner);
     }
-    TimeType early_fall_arrival(Pin p) const {
-        return m_early_sta->fall_arrival(p);
+    TimeType early_fall_arrival(Pin p, std::size_t corner = 0) const {
+        return m_early_sta->fall_arrival(p, corner);
     }
-    TimeType late_rise_arrival(Pin p) const {
-        return m_late_sta->rise_arrival(p);
+    TimeType late_rise_arrival(Pin p, std::size_t corner = 0) const {
+        return m_late_sta->rise_arrival(p, corner);
     }
-    TimeType late_fall_arrival(Pin p) const {
-        return m_late_sta->fall_arrival(p);
+    TimeType late_fall_arrival(Pin p, std::size_t corner = 0) const {
+        return m_late_sta->fall_arrival(p, corner);
     }
 
-    TimeType early_rise_slew(Pin p) const {
-        return m_early_sta->rise_slew(p);
+    TimeType early_rise_slew(Pin p, std::size_t corner = 0) const {
+        return m_early_sta->rise_slew(p, corner);
+    }
+    TimeType early_fall_slew(Pin p, std::size_t corner = 0) const {
+        return m_early_sta->fall_slew(p, corner);
     }
-    TimeType early_fall_slew(Pin p) const {
-        return m_early_sta->fall_slew(p);
+    TimeType late_rise_slew(Pin p, std::size_t corner = 0) const {
+        return m_late_sta->rise_slew(p, corner);
     }
-    TimeType late_rise_slew(Pin p) const {
-        return m_late_sta->rise_slew(p);
+    TimeType late_fall_slew(Pin p, std::size_t corner = 0) const {
+        return m_late_sta->fall_slew(p, corner);
     }
-    TimeType late_fall_slew(Pin p) const {
-        return m_late_sta->fall_slew(p);
+
+    // arrivals and slacks of many pins in one call, in the order of pins
+    void late_timing(const std::vector<Pin> & pins, std::vector<pin_timing> & timing, std::size_t corner = 0) const {
+        m_late_sta->pins_timing(pins, timing, corner);
     }
+    void early_timing(const std::vector<Pin> & pins, std::vector<pin_timing> & timing, std::size_t corner = 0) const {
+        m_early_sta->pins_timing(pins, timing, corner);
+    }
+
+    // the k worst paths of the corner, worst first
+    std::vector<timing_path> late_worst_paths(std::size_t k, std::size_t corner = 0) const;
+    std::vector<timing_path> early_worst_paths(std::size_t k, std::size_t corner = 0) const;
 
     const endpoints & timing_endpoints() const {
         return m_endpoints;
@@ -33,11 +33,11 @@ class wns
     boost::units::quantity< boost::units::si::time > m_value;
 public:
     template <class POsContainer, class WireDelayModel, class MergeStrategy>
-    wns(const POsContainer& POs, const generic_sta<WireDelayModel, MergeStrategy> & sta) :
+    wns(const POsContainer& POs, const generic_sta<WireDelayModel, MergeStrategy> & sta, std::size_t corner = 0) :
         m_value(std::numeric_limits<boost::units::quantity< boost::units::si::time > >::max())
     {
         for(auto PO : POs)
-            m_value = std::min(m_value, std::min(sta.rise_slack(PO), sta.fall_slack(PO)));
+            m_value = std::min(m_value, std::min(sta.rise_slack(PO, corner), sta.fall_slack(PO, corner)));
     }
     virtual ~wns();
 
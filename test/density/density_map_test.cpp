@@ -0,0 +1,90 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#include "../catch.hpp"
+
+#include "../parsing/lef.h"
+#include "../parsing/def.h"
+
+#include "../placement/def2placement.h"
+#include "../placement/lef2library.h"
+#include "../floorplan/lefdef2floorplan.h"
+
+#include "density_map.h"
+
+using namespace ophidian;
+
+TEST_CASE("density/ moving cells updates the grid like a rebuild","[density]") {
+    standard_cell::standard_cells std_cells;
+    netlist::netlist netlist(&std_cells);
+    placement::library lib(&std_cells);
+    placement::placement cells(&netlist, &lib);
+    floorplan::floorplan floorplan;
+
+    parsing::lef lef("input_files/simple.lef");
+    parsing::def def("input_files/simple.def");
+    placement::lef2library(lef, lib);
+    placement::def2placement(def, cells);
+    floorplan::lefdef2floorplan(lef, def, floorplan);
+
+    double row_height = floorplan.row_dimensions(*floorplan.rows_system().begin()).y();
+    geometry::point<double> bin_dimensions(2 * row_height, 2 * row_height);
+
+    density::density_map incremental(&floorplan, &cells);
+    incremental.build_grid(bin_dimensions);
+    REQUIRE( incremental.bin_count() == 8 );
+    REQUIRE( incremental.bin_position(incremental.bin_at({2 * row_height + 1, 1})).x() == 2 * row_height );
+
+    auto u1 = netlist.cell_find("u1");
+    auto u4 = netlist.cell_find("u4");
+    std::vector<std::pair<entity_system::entity, geometry::point<double>>> moves = {
+        {u1, {20000, 0}}, {u4, {0, 10260}}, {u1, {13000, 5000}}
+    };
+    for (auto & move : moves) {
+        auto old_position = cells.cell_position(move.first);
+        cells.cell_position(move.first, move.second);
+        incremental.cell_moved(move.first, old_position, move.second);
+    }
+
+    density::density_map rebuilt(&floorplan, &cells);
+    rebuilt.build_grid(bin_dimensions);
+    for (auto bin : rebuilt.bins_system()) {
+        REQUIRE( incremental.bin_movable_utilization(bin) == Approx(rebuilt.bin_movable_utilization(bin)) );
+        REQUIRE( incremental.bin_fixed_utilization(bin) == Approx(rebuilt.bin_fixed_utilization(bin)) );
+        REQUIRE( incremental.bin_free_space(bin) == Approx(rebuilt.bin_free_space(bin)) );
+    }
+
+    auto & movable_utilizations = incremental.bins_properties().movable_utilizations();
+    REQUIRE( movable_utilizations.size() == incremental.bin_count() );
+    for (auto bin : incremental.bins_system()) {
+        REQUIRE( movable_utilizations[incremental.bins_system().lookup(bin)] == incremental.bin_movable_utilization(bin) );
+    }
+
+    // moves that only reach the placement, then a single update of the bins
+    cells.cell_position(u1, {5000, 3000});
+    cells.cell_position(u4, {21000, 9000});
+    incremental.update_movable_utilizations();
+    density::density_map moved(&floorplan, &cells);
+    moved.build_grid(bin_dimensions);
+    for (auto bin : moved.bins_system()) {
+        REQUIRE( incremental.bin_movable_utilization(bin) == Approx(moved.bin_movable_utilization(bin)) );
+        REQUIRE( incremental.bin_fixed_utilization(bin) == Approx(moved.bin_fixed_utilization(bin)) );
+    }
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#include "../catch.hpp"
+
+#include <cmath>
+
+#include "../parsing/lef.h"
+#include "../parsing/def.h"
+
+#include "../placement/def2placement.h"
+#include "../placement/lef2library.h"
+#include "../floorplan/lefdef2floorplan.h"
+
+#include "electrostatics.h"
+
+using namespace ophidian;
+
+TEST_CASE("density/ electrostatic potential and field","[density][electrostatics]") {
+    standard_cell::standard_cells std_cells;
+    netlist::netlist netlist(&std_cells);
+    placement::library lib(&std_cells);
+    placement::placement cells(&netlist, &lib);
+    floorplan::floorplan floorplan;
+
+    parsing::lef lef("input_files/simple.lef");
+    parsing::def def("input_files/simple.def");
+    placement::lef2library(lef, lib);
+    placement::def2placement(def, cells);
+    floorplan::lefdef2floorplan(lef, def, floorplan);
+
+    REQUIRE_THROWS( density::electrostatics(&floorplan, &cells, 6, 4) );
+
+    const std::size_t columns = 8, rows = 4;
+    density::electrostatics electrostatics(&floorplan, &cells, columns, rows);
+    electrostatics.update();
+
+    // compare the spectral solution with the cosine series evaluated directly
+    const double width = floorplan.chip_boundaries().x();
+    const double height = floorplan.chip_boundaries().y();
+    const auto & density = electrostatics.charge_density();
+    for (std::size_t y = 0; y < rows; ++y) {
+        for (std::size_t x = 0; x < columns; ++x) {
+            double potential = 0.0, field_x = 0.0;
+            for (std::size_t v = 0; v < rows; ++v) {
+                for (std::size_t u = 0; u < columns; ++u) {
+                    if (u == 0 && v == 0) {
+                        continue;
+                    }
+                    double coefficient = 0.0;
+                    for (std::size_t j = 0; j < rows; ++j) {
+                        for (std::size_t i = 0; i < columns; ++i) {
+                            coefficient += density[j * columns + i] * std::cos(M_PI * u * (2 * i + 1) / (2.0 * columns)) * std::cos(M_PI * v * (2 * j + 1) / (2.0 * rows));
+                        }
+                    }
+                    coefficient *= (u ? 2.0 : 1.0) * (v ? 2.0 : 1.0) / (columns * rows);
+                    double w_u = M_PI * u / width, w_v = M_PI * v / height;
+                    coefficient /= w_u * w_u + w_v * w_v;
+                    potential += coefficient * std::cos(M_PI * u * (2 * x + 1) / (2.0 * columns)) * std::cos(M_PI * v * (2 * y + 1) / (2.0 * rows));
+                    field_x += coefficient * w_u * std::sin(M_PI * u * (2 * x + 1) / (2.0 * columns)) * std::cos(M_PI * v * (2 * y + 1) / (2.0 * rows));
+                }
+            }
+            REQUIRE( electrostatics.potential()[y * columns + x] == Approx(potential) );
+            REQUIRE( electrostatics.field_x()[y * columns + x] == Approx(field_x).epsilon(1e-6) );
+        }
+    }
+    REQUIRE( electrostatics.energy() > 0.0 );
+}
+
+TEST_CASE("density/ electrostatic gradient pushes cells out of dense regions","[density][electrostatics]") {
+    standard_cell::standard_cells std_cells;
+    netlist::netlist netlist(&std_cells);
+    placement::library lib(&std_cells);
+    placement::placement cells(&netlist, &lib);
+    floorplan::floorplan floorplan;
+
+    parsing::lef lef("input_files/simple.lef");
+    parsing::def def("input_files/simple.def");
+    placement::lef2library(lef, lib);
+    placement::def2placement(def, cells);
+    floorplan::lefdef2floorplan(lef, def, floorplan);
+
+    density::electrostatics electrostatics(&floorplan, &cells, 8, 4);
+    for (auto name : {"u1", "u2", "u3"}) {
+        auto cell = netlist.cell_find(name);
+        auto old_position = cells.cell_position(cell);
+        geometry::point<double> stacked(13680, 6840);
+        cells.cell_position(cell, stacked);
+        electrostatics.cell_moved(cell, old_position, stacked);
+    }
+    auto u4 = netlist.cell_find("u4");
+    auto old_position = cells.cell_position(u4);
+    geometry::point<double> right_of_stack(17100, 6840);
+    cells.cell_position(u4, right_of_stack);
+    electrostatics.cell_moved(u4, old_position, right_of_stack);
+    electrostatics.update();
+
+    std::vector<geometry::point<double>> gradients;
+    electrostatics.gradients(gradients);
+    REQUIRE( gradients.size() == netlist.cell_system().size() );
+    REQUIRE( gradients[netlist.cell_system().lookup(u4)].x() < 0.0 );
+    auto f1 = netlist.cell_find("f1");
+    REQUIRE( gradients[netlist.cell_system().lookup(f1)].x() == 0.0 );
+    REQUIRE( gradients[netlist.cell_system().lookup(f1)].y() == 0.0 );
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#include "../catch.hpp"
+
+#include <cmath>
+
+#include "../parsing/lef.h"
+#include "../parsing/def.h"
+#include "../parsing/verilog.h"
+#include "../netlist/verilog2netlist.h"
+#include "../placement/def2placement.h"
+#include "../placement/lef2library.h"
+#include "../floorplan/lefdef2floorplan.h"
+#include "../legalization/algorithms/abacus.h"
+#include "../legalization/legalization_check.h"
+
+#include "analytic_placer.h"
+
+using namespace ophidian;
+
+TEST_CASE("global placement/ conjugate gradient solves a laplacian system", "[global_placement]") {
+    // a chain of springs anchored at both ends: the solution is evenly spaced
+    const std::size_t size = 50;
+    std::vector<global_placement::triplet> triplets;
+    std::vector<double> b(size, 0.0);
+    for (std::size_t i = 0; i < size; ++i) {
+        triplets.push_back({i, i, 2.0});
+        if (i > 0) {
+            triplets.push_back({i, i - 1, -1.0});
+            triplets.push_back({i - 1, i, -1.0});
+        }
+    }
+    b.back() = size + 1;
+    global_placement::sparse_matrix A(size, triplets);
+    REQUIRE(A.non_zeros() == 3 * size - 2);
+
+    std::vector<double> x(size, 0.0);
+    auto iterations = global_placement::conjugate_gradient(A, b, x, 1e-10);
+    REQUIRE(iterations <= size);
+    for (std::size_t i = 0; i < size; ++i) {
+        REQUIRE(std::abs(x[i] - (i + 1)) < 1e-6);
+    }
+}
+
+TEST_CASE("global placement/ placing simple from scratch", "[global_placement]") {
+    standard_cell::standard_cells std_cells;
+    netlist::netlist netlist(&std_cells);
+    placement::library lib(&std_cells);
+    placement::placement placement(&netlist, &lib);
+    floorplan::floorplan floorplan;
+    parsing::verilog verilog("input_files/simple.v");
+    netlist::verilog2netlist(verilog, netlist);
+    parsing::lef lef("input_files/simple.lef");
+    parsing::def def("input_files/simple.def");
+    placement::lef2library(lef, lib);
+    placement::def2placement(def, placement);
+    floorplan::lefdef2floorplan(lef, def, floorplan);
+
+    global_placement::analytic_placer placer(&floorplan, &placement);
+    REQUIRE(placer.movable_cell_count() == 5);
+    placer.place();
+    REQUIRE(!placer.report().empty());
+
+    for (auto cell : netlist.cell_system()) {
+        auto position = placement.cell_position(cell);
+        REQUIRE(position.x() >= floorplan.chip_origin().x());
+        REQUIRE(position.y() >= floorplan.chip_origin().y());
+        REQUIRE(position.x() + placement.cell_dimensions(cell).x() <= floorplan.chip_boundaries().x());
+        REQUIRE(position.y() + placement.cell_dimensions(cell).y() <= floorplan.chip_boundaries().y());
+    }
+
+    legalization::abacus::abacus abacus(&floorplan, &placement);
+    abacus.legalize_placement();
+    legalization::legalization_check legalization_check(&floorplan, &placement);
+    REQUIRE(legalization_check.check_legality());
+}
@@ -0,0 +1,42 @@
+/* simple.v with comments in the places a tokenizer can get wrong;
+   endmodule; wire n0; // not a line comment here */
+module simple (
+inp1, // first input; not a statement
+inp2,
+iccad_clk,
+out
+);
+
+// Start PIs
+input inp1;
+input /* a comment; in a statement */ inp2;
+input iccad_clk;
+
+/* Start POs */
+output out;
+
+// Start wires
+wire n1; /* wire n5; */
+wire n2;
+wire n3;
+wire n4;
+wire inp1;
+wire inp2;
+wire iccad_clk;
+wire out;
+wire lcb1_fo;//no space before this comment
+
+// Start cells
+NAND2_X1 u1 ( .a(inp1), .b(inp2), .o(n1) );
+NOR2_X1 u2 ( .a(n1), /* .c(n5), */ .b(n3), .o(n2) );
+DFF_X80 f1 (
+  .d(n2),  // data
+  .ck(lcb1_fo),
+  .q(n3)
+);
+INV_X1 u3 ( .a(n3), .o(n4) );
+INV_X1 u4 ( .a(n4), .o(out) );
+INV_Z80 lcb1 ( .a(iccad_clk), .o(lcb1_fo) );
+
+endmodule
+/* unterminated comment at the end of the file; endmodule
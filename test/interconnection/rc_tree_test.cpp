@@ -129,7 +129,28 @@ TEST_CASE("rc_tree/pack test", "[timing][rc_tree]")
 
 }
 
-
-
-
-
+TEST_CASE("rc_tree/pack taps by pin", "[timing][rc_tree]")
+{
+    ophidian::interconnection::rc_tree tree;
+    using namespace boost::units;
+    using namespace boost::units::si;
+    using ophidian::entity_system::entity;
+    auto u1o = tree.capacitor_insert("u1:o");
+    auto n1 = tree.capacitor_insert("n1");
+    auto u2a = tree.capacitor_insert("u2:a");
+    tree.capacitance(u2a, quantity<capacitance>(2.0*farads));
+    tree.resistor_insert(u1o, n1, quantity<resistance>(1.0*ohms));
+    tree.resistor_insert(n1, u2a, quantity<resistance>(3.0*ohms));
+    tree.tap_insert(u1o, entity(7));
+    tree.tap_insert(u2a, entity(3));
+    auto packed = tree.pack(u1o);
+    REQUIRE( packed.has_pin_taps() );
+    REQUIRE( packed.tap(entity(7)) == 0 );
+    REQUIRE( packed.tap(entity(3)) == 2 );
+    REQUIRE( packed.tap("u2:a") == 2 );
+    REQUIRE_THROWS( packed.tap(entity(4)) );
+    REQUIRE( packed.preds()[2] == 1 );
+    REQUIRE( packed.resistances()[2] == 3.0 );
+    REQUIRE( packed.capacitances()[2] == 2.0 );
+    REQUIRE( (packed.capacitance(2) == quantity<capacitance>(2.0*farads)) );
+}
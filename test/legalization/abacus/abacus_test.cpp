@@ -4,6 +4,9 @@
 
 #include <fstream>
 #include <sys/time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "../../catch.hpp"
 
 #include "lef.h"
@@ -57,3 +60,57 @@ TEST_CASE("legalization/ legalizing simple after random movements","[legalizatio
 
     REQUIRE(legalization_check.check_legality());
 }
+
+TEST_CASE("legalization/ banded legalization does not depend on the number of threads","[legalization][abacus]") {
+    ophidian::parsing::lef lef("input_files/simple.lef");
+    ophidian::parsing::def def("input_files/simple.def");
+
+    ophidian::standard_cell::standard_cells std_cells;
+    ophidian::netlist::netlist netlist(&std_cells);
+    ophidian::placement::library lib(&std_cells);
+    ophidian::placement::placement placement(&netlist, &lib);
+    ophidian::floorplan::floorplan floorplan;
+    ophidian::placement::def2placement(def, placement);
+    ophidian::placement::lef2library(lef, lib);
+    ophidian::floorplan::lefdef2floorplan(lef, def, floorplan);
+
+    std::vector<ophidian::geometry::point<double>> initial_positions;
+    for (auto cell : netlist.cell_system()) {
+        initial_positions.push_back(placement.cell_position(cell));
+    }
+
+#ifdef _OPENMP
+    int max_threads = omp_get_max_threads();
+#endif
+    std::vector<std::vector<ophidian::geometry::point<double>>> legalized_positions;
+    for (int threads : {1, 4}) {
+#ifdef _OPENMP
+        omp_set_num_threads(threads);
+#endif
+        std::size_t i = 0;
+        for (auto cell : netlist.cell_system()) {
+            if (!placement.cell_fixed(cell)) {
+                placement.cell_position(cell, initial_positions[i]);
+            }
+            ++i;
+        }
+
+        ophidian::legalization::abacus::abacus abacus(&floorplan, &placement, 2);
+        abacus.legalize_placement();
+        ophidian::legalization::legalization_check legalization_check(&floorplan, &placement);
+        REQUIRE(legalization_check.check_legality());
+
+        legalized_positions.push_back({});
+        for (auto cell : netlist.cell_system()) {
+            legalized_positions.back().push_back(placement.cell_position(cell));
+        }
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(max_threads);
+#endif
+
+    for (std::size_t i = 0; i < legalized_positions.front().size(); ++i) {
+        REQUIRE(legalized_positions[0][i].x() == legalized_positions[1][i].x());
+        REQUIRE(legalized_positions[0][i].y() == legalized_positions[1][i].y());
+    }
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#include "../catch.hpp"
+
+#include "lef.h"
+#include "def.h"
+
+#include "def2placement.h"
+#include "lef2library.h"
+#include "lefdef2floorplan.h"
+#include "legalization_check.h"
+
+TEST_CASE("legalization/ legality report lists every violation","[legalization]") {
+    ophidian::parsing::lef lef("input_files/simple.lef");
+    ophidian::parsing::def def("input_files/simple.def");
+
+    ophidian::standard_cell::standard_cells std_cells;
+    ophidian::netlist::netlist netlist(&std_cells);
+    ophidian::placement::library lib(&std_cells);
+    ophidian::placement::placement placement(&netlist, &lib);
+    ophidian::floorplan::floorplan floorplan;
+    ophidian::placement::def2placement(def, placement);
+    ophidian::placement::lef2library(lef, lib);
+    ophidian::floorplan::lefdef2floorplan(lef, def, floorplan);
+
+    ophidian::legalization::legalization_check legalization_check(&floorplan, &placement);
+    REQUIRE(legalization_check.check_legality());
+    REQUIRE(legalization_check.report().legal());
+
+    auto u1 = netlist.cell_find("u1");
+    auto u2 = netlist.cell_find("u2");
+    auto u3 = netlist.cell_find("u3");
+    auto u4 = netlist.cell_find("u4");
+    // u1 lands on u2, u3 leaves the sites and u4 leaves the chip
+    placement.cell_position(u1, placement.cell_position(u2));
+    placement.cell_position(u3, {6841, 3420});
+    placement.cell_position(u4, {floorplan.chip_boundaries().x() - 380, 6840});
+
+    auto report = legalization_check.report();
+    REQUIRE(!report.legal());
+    REQUIRE(!legalization_check.check_legality());
+    REQUIRE(report.out_of_boundaries == std::vector<ophidian::entity_system::entity>{u4});
+    REQUIRE(report.misaligned == std::vector<ophidian::entity_system::entity>{u3});
+    REQUIRE(report.overlaps == 1);
+    REQUIRE(report.worst_overlaps.size() == 1);
+    auto overlap = report.worst_overlaps.front();
+    REQUIRE(((overlap.first == u1 && overlap.second == u2) || (overlap.first == u2 && overlap.second == u1)));
+    auto u1_dimensions = placement.cell_dimensions(u1);
+    auto u2_dimensions = placement.cell_dimensions(u2);
+    REQUIRE(overlap.area == std::min(u1_dimensions.x(), u2_dimensions.x()) * std::min(u1_dimensions.y(), u2_dimensions.y()));
+
+    REQUIRE(legalization_check.report(0).worst_overlaps.empty());
+}
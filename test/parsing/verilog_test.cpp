@@ -22,6 +22,9 @@ under the License.
 
 #include "../parsing/verilog.h"
 
+#include <algorithm>
+#include <omp.h>
+
 using namespace ophidian;
 
 
@@ -98,3 +101,78 @@ TEST_CASE("verilog/read","[verilog]") {
 
 }
 
+TEST_CASE("verilog/interned names","[verilog]") {
+
+    parsing::verilog v("input_files/simple.v");
+    auto name = [&v](parsing::verilog::name_id id) -> const std::string & {
+        return v.names().at(id);
+    };
+
+    // every name is stored once
+    std::vector<std::string> names(v.names());
+    std::sort(names.begin(), names.end());
+    REQUIRE( std::adjacent_find(names.begin(), names.end()) == names.end() );
+
+    REQUIRE( v.input_ids().size() == v.inputs().size() );
+    for(std::size_t i = 0; i < v.inputs().size(); ++i)
+        REQUIRE( name(v.input_ids()[i]) == v.inputs()[i] );
+    REQUIRE( v.output_ids().size() == 1 );
+    REQUIRE( name(v.output_ids().front()) == "out" );
+    REQUIRE( v.net_ids().size() == v.wires().size() );
+    for(std::size_t i = 0; i < v.wires().size(); ++i)
+        REQUIRE( name(v.net_ids()[i]) == v.wires()[i] );
+
+    REQUIRE( v.cell_count() == 6 );
+    REQUIRE( v.instances().size() == v.modules().size() );
+    REQUIRE( v.instances().back().pins_end == v.instance_pins().size() );
+    for(std::size_t i = 0; i < v.instances().size(); ++i)
+    {
+        const parsing::verilog::instance & cell = v.instances()[i];
+        const parsing::verilog::module & module = v.modules()[i];
+        REQUIRE( name(cell.type) == module.type );
+        REQUIRE( name(cell.name) == module.name );
+        REQUIRE( cell.pins_end - cell.pins_begin == module.pinnet_pairs.size() );
+        for(std::size_t p = cell.pins_begin; p < cell.pins_end; ++p)
+        {
+            REQUIRE( name(v.instance_pins()[p].first) == module.pinnet_pairs[p - cell.pins_begin].first );
+            REQUIRE( name(v.instance_pins()[p].second) == module.pinnet_pairs[p - cell.pins_begin].second );
+        }
+    }
+
+    // a net connected to many pins has a single id
+    const auto & u1 = v.instances().front();
+    const auto & u2 = v.instances()[1];
+    REQUIRE( v.instance_pins()[u1.pins_begin+2].second == v.instance_pins()[u2.pins_begin].second ); // n1
+    REQUIRE( v.pin_count() == 3 + 1 + v.instance_pins().size() );
+    REQUIRE( v.net_count() == 9 );
+}
+
+TEST_CASE("verilog/comments","[verilog]") {
+
+    parsing::verilog golden("input_files/simple.v");
+    parsing::verilog v("input_files/simple_comments.v");
+    REQUIRE( v.design() == golden.design() );
+    REQUIRE( v.inputs() == golden.inputs() );
+    REQUIRE( v.outputs() == golden.outputs() );
+    REQUIRE( v.wires() == golden.wires() );
+    REQUIRE( v.modules() == golden.modules() );
+    REQUIRE( v.pin_count() == golden.pin_count() );
+}
+
+TEST_CASE("verilog/string views built concurrently","[verilog]") {
+
+    parsing::verilog golden("input_files/simple.v");
+    const std::vector<parsing::verilog::module> modules = golden.modules();
+    const std::vector<std::string> wires = golden.wires();
+
+    parsing::verilog v("input_files/simple.v");
+    const int threads = omp_get_max_threads();
+    omp_set_num_threads(std::max(threads, 4));
+    std::vector<char> same(64, 0);
+#pragma omp parallel for schedule(static, 1)
+    for(std::size_t i = 0; i < same.size(); ++i)
+        same[i] = v.modules() == modules && v.wires() == wires;
+    omp_set_num_threads(threads);
+    REQUIRE( std::all_of(same.begin(), same.end(), [](char c){ return c == 1; }) );
+    REQUIRE( &v.modules() == &v.modules() );
+}
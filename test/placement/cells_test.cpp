@@ -53,11 +53,13 @@ TEST_CASE("placement cell info", "[placement]") {
 
 	ophidian::placement::cells cells(&netlist);
 	cells.position(u1, { 0.0, 0.0 });
-	cells.geometry(u1, lib.geometry(INV_X1));
 	cells.fixed(u1, false);
 	REQUIRE(
 			boost::geometry::equals(cells.position(u1),
 					ophidian::geometry::point<double>(0.0, 0.0)));
-	REQUIRE(boost::geometry::equals(cells.geometry(u1), lib.geometry(INV_X1)));
+	ophidian::geometry::box<ophidian::geometry::point<double> > bounds { { 0.0, 0.0 }, { 800.0, 200.0 } };
+	REQUIRE(lib.rectangles(INV_X1).size() == 1);
+	REQUIRE(boost::geometry::equals(lib.rectangles(INV_X1).front(), bounds));
+	REQUIRE(boost::geometry::equals(lib.bounds(INV_X1), bounds));
 	REQUIRE(cells.fixed(u1) == false);
 }
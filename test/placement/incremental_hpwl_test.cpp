@@ -0,0 +1,144 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#include "../catch.hpp"
+
+#include <random>
+
+#include "../parsing/lef.h"
+#include "../parsing/def.h"
+#include "../parsing/verilog.h"
+#include "../netlist/verilog2netlist.h"
+#include "../placement/def2placement.h"
+#include "../placement/lef2library.h"
+#include "../placement/hpwl.h"
+#include "../placement/incremental_hpwl.h"
+
+using namespace ophidian;
+
+TEST_CASE("placement/incremental hpwl follows random moves", "[placement][hpwl]") {
+    standard_cell::standard_cells std_cells;
+    netlist::netlist netlist(&std_cells);
+    placement::library lib(&std_cells);
+    placement::placement placement(&netlist, &lib);
+    parsing::verilog verilog("input_files/simple.v");
+    netlist::verilog2netlist(verilog, netlist);
+    parsing::lef lef("input_files/simple.lef");
+    parsing::def def("input_files/simple.def");
+    placement::lef2library(lef, lib);
+    placement::def2placement(def, placement);
+
+    placement::incremental_hpwl wirelength(placement);
+    REQUIRE(wirelength.value() == Approx(placement::hpwl(placement).value()));
+
+    std::vector<entity_system::entity> cells;
+    for (auto cell : netlist.cell_system()) {
+        if (!placement.cell_fixed(cell)) {
+            cells.push_back(cell);
+        }
+    }
+    std::default_random_engine generator;
+    std::uniform_int_distribution<std::size_t> cell_distribution(0, cells.size() - 1);
+    // a small grid makes pins share box edges often
+    std::uniform_int_distribution<int> coordinate_distribution(0, 8);
+    for (int move = 0; move < 200; ++move) {
+        auto cell = cells[cell_distribution(generator)];
+        geometry::point<double> position(coordinate_distribution(generator) * 3420.0, coordinate_distribution(generator) * 3420.0);
+        placement.cell_position(cell, position);
+        wirelength.cell_moved(cell, position);
+        REQUIRE(wirelength.value() == Approx(placement::hpwl(placement).value()));
+        for (auto net : netlist.net_system()) {
+            REQUIRE(wirelength.net_value(net) == Approx(placement::hpwl(placement, net).value()));
+        }
+    }
+
+    std::vector<geometry::point<double>> positions;
+    for (auto cell : cells) {
+        positions.push_back(geometry::point<double>(coordinate_distribution(generator) * 380.0, coordinate_distribution(generator) * 3420.0));
+        placement.cell_position(cell, positions.back());
+    }
+    wirelength.cells_moved(cells, positions);
+    REQUIRE(wirelength.value() == Approx(placement::hpwl(placement).value()));
+
+    placement.cell_position(cells.front(), geometry::point<double>(0.0, 0.0));
+    wirelength.recompute(placement);
+    REQUIRE(wirelength.value() == Approx(placement::hpwl(placement).value()));
+}
+
+TEST_CASE("placement/incremental hpwl reloads pads on recompute", "[placement][hpwl]") {
+    standard_cell::standard_cells std_cells;
+    netlist::netlist netlist(&std_cells);
+    placement::library lib(&std_cells);
+    placement::placement placement(&netlist, &lib);
+    parsing::verilog verilog("input_files/simple.v");
+    netlist::verilog2netlist(verilog, netlist);
+    parsing::lef lef("input_files/simple.lef");
+    parsing::def def("input_files/simple.def");
+    placement::lef2library(lef, lib);
+    placement::def2placement(def, placement);
+
+    placement::incremental_hpwl wirelength(placement);
+    auto pad = netlist.pin_by_name("inp1");
+    auto net = netlist.pin_net(pad);
+    const double before = wirelength.net_value(net);
+    placement.pad_position(pad, geometry::point<double>(1e6, 1e6));
+    REQUIRE(placement::hpwl(placement, net).value() > before);
+    wirelength.recompute(placement);
+    REQUIRE(wirelength.net_value(net) == Approx(placement::hpwl(placement, net).value()));
+    REQUIRE(wirelength.value() == Approx(placement::hpwl(placement).value()));
+}
+
+TEST_CASE("placement/incremental hpwl does not drift", "[placement][hpwl]") {
+    standard_cell::standard_cells std_cells;
+    netlist::netlist netlist(&std_cells);
+    placement::library lib(&std_cells);
+    placement::placement placement(&netlist, &lib);
+    parsing::verilog verilog("input_files/simple.v");
+    netlist::verilog2netlist(verilog, netlist);
+    parsing::lef lef("input_files/simple.lef");
+    parsing::def def("input_files/simple.def");
+    placement::lef2library(lef, lib);
+    placement::def2placement(def, placement);
+
+    placement::incremental_hpwl wirelength(placement);
+    std::vector<entity_system::entity> cells;
+    for (auto cell : netlist.cell_system()) {
+        if (!placement.cell_fixed(cell)) {
+            cells.push_back(cell);
+        }
+    }
+    std::default_random_engine generator;
+    std::uniform_int_distribution<std::size_t> cell_distribution(0, cells.size() - 1);
+    std::uniform_real_distribution<double> coordinate_distribution(0.0, 30000.0);
+    auto move = [&](double scale) {
+        auto cell = cells[cell_distribution(generator)];
+        geometry::point<double> position(coordinate_distribution(generator) * scale, coordinate_distribution(generator) * scale);
+        placement.cell_position(cell, position);
+        wirelength.cell_moved(cell, position);
+    };
+    // far moves make each difference lose the low bits of the total
+    for (int i = 0; i < 100000; ++i) {
+        move(i % 2 ? 1.0 : 1e8);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        move(1.0);
+    }
+    REQUIRE(wirelength.value() == Approx(placement::hpwl(placement).value()).epsilon(1e-12));
+}
@@ -117,3 +117,48 @@ TEST_CASE("placement/trying to move fixed cell", "[placement]") {
     REQUIRE(placement.pin_position(u1o).x() == 103.0);
     REQUIRE(placement.pin_position(u1o).y() == 204.0);
 }
+
+TEST_CASE("placement/cached pin positions", "[placement]") {
+	ophidian::standard_cell::standard_cells std_cells;
+	ophidian::netlist::netlist netlist(&std_cells);
+	ophidian::placement::library lib { &std_cells };
+	ophidian::placement::placement placement { &netlist, &lib };
+
+	auto INV_X1 = std_cells.cell_create("INV_X1");
+	auto INV_X1a = std_cells.pin_create(INV_X1, "a");
+	auto INV_X1o = std_cells.pin_create(INV_X1, "o");
+
+	lib.pin_offset(INV_X1a, { 1.0, 2.0 });
+	lib.pin_offset(INV_X1o, { 3.0, 4.0 });
+
+	auto u1 = netlist.cell_insert("u1", "INV_X1");
+	auto u1a = netlist.pin_insert(u1, "a");
+	auto u1o = netlist.pin_insert(u1, "o");
+	auto inp1 = netlist.PI_insert("inp1");
+	placement.cell_position(u1, { 100.0, 200.0 });
+	placement.pad_position(inp1, { 5.0, 6.0 });
+
+	REQUIRE(!placement.pin_positions_cached());
+	placement.cache_pin_positions();
+	REQUIRE(placement.pin_positions_cached());
+	REQUIRE(placement.pin_positions().data()[netlist.pin_system().lookup(u1o)].x() == 103.0);
+
+	REQUIRE(placement.pin_position(u1a).x() == 101.0);
+	REQUIRE(placement.pin_position(u1a).y() == 202.0);
+	REQUIRE(placement.pin_position(inp1).x() == 5.0);
+	REQUIRE(placement.pin_position(inp1).y() == 6.0);
+
+	placement.cell_position(u1, { 300.0, 400.0 });
+	placement.pad_position(inp1, { 7.0, 8.0 });
+
+	REQUIRE(placement.pin_position(u1a).x() == 301.0);
+	REQUIRE(placement.pin_position(u1a).y() == 402.0);
+	REQUIRE(placement.pin_position(u1o).x() == 303.0);
+	REQUIRE(placement.pin_position(u1o).y() == 404.0);
+	REQUIRE(placement.pin_position(inp1).x() == 7.0);
+	REQUIRE(placement.pin_position(inp1).y() == 8.0);
+
+	placement.cell_fixed(u1, true);
+	placement.cell_position(u1, { 500.0, 600.0 });
+	REQUIRE(placement.pin_position(u1a).x() == 301.0);
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2016 Ophidian
+Licensed to the Apache Software Foundation (ASF) under one
+or more contributor license agreements.  See the NOTICE file
+distributed with this work for additional information
+regarding copyright ownership.  The ASF licenses this file
+to you under the Apache License, Version 2.0 (the
+"License"); you may not use this file except in compliance
+with the License.  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing,
+software distributed under the License is distributed on an
+"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+KIND, either express or implied.  See the License for the
+specific language governing permissions and limitations
+under the License.
+ */
+
+#include "../catch.hpp"
+
+#include "../timing/endpoint_slacks.h"
+
+#include <algorithm>
+
+TEST_CASE("endpoint slacks/empty", "[timing][endpoint_slacks]") {
+    ophidian::timing::endpoint_slacks slacks;
+    REQUIRE( slacks.size() == 0 );
+    REQUIRE( slacks.worst() == std::numeric_limits<ophidian::timing::endpoint_slacks::TimeType>::max() );
+    REQUIRE( slacks.total_negative() == ophidian::timing::endpoint_slacks::TimeType() );
+}
+
+TEST_CASE("endpoint slacks/updates match a full rebuild", "[timing][endpoint_slacks]") {
+    using namespace ophidian;
+    using TimeType = timing::endpoint_slacks::TimeType;
+    std::vector<TimeType> values;
+    for(int i = 0; i < 13; ++i)
+        values.push_back(TimeType(((i * 7) % 13 - 5) * boost::units::si::seconds));
+
+    timing::endpoint_slacks slacks;
+    slacks.assign(values);
+    REQUIRE( slacks.size() == values.size() );
+    REQUIRE( slacks.worst() == TimeType(-5.0 * boost::units::si::seconds) );
+    REQUIRE( slacks.total_negative() == TimeType(-15.0 * boost::units::si::seconds) );
+
+    values[3] = TimeType(-9.0 * boost::units::si::seconds);
+    values[7] = TimeType(4.0 * boost::units::si::seconds);
+    slacks.update(3, values[3]);
+    slacks.update(7, values[7]);
+    timing::endpoint_slacks rebuilt;
+    rebuilt.assign(values);
+    REQUIRE( slacks.worst() == TimeType(-9.0 * boost::units::si::seconds) );
+    REQUIRE( slacks.worst() == rebuilt.worst() );
+    REQUIRE( slacks.total_negative() == rebuilt.total_negative() );
+    REQUIRE( slacks.slack(3) == values[3] );
+
+    auto histogram = slacks.histogram(TimeType(-5.0 * boost::units::si::seconds), TimeType(5.0 * boost::units::si::seconds), 2);
+    REQUIRE( histogram.size() == 2 );
+    REQUIRE( histogram[0] + histogram[1] == values.size() );
+    REQUIRE( histogram[0] == static_cast<std::size_t>(std::count_if(values.begin(), values.end(), [](TimeType s) { return s < TimeType(); })) );
+}
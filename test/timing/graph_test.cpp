@@ -21,6 +21,7 @@ under the License.
 #include "../catch.hpp"
 
 #include "../timing/graph.h"
+#include "../timing/csr_graph.h"
 #include "../entity_system/entity.h"
 
 TEST_CASE("timing graph/", "[timing][graph]") {
@@ -96,6 +97,37 @@ TEST_CASE("timing graph/out edges", "[timing][graph]") {
 	REQUIRE(visited[edge2] == visited_GOLDEN[edge2]);
 }
 
+TEST_CASE("timing graph/csr snapshot", "[timing][graph]") {
+	using namespace ophidian;
+	timing::graph g;
+    entity_system::entity i { 0 };
+    entity_system::entity j { 1 };
+    entity_system::entity k { 2 };
+    entity_system::entity tarc { 3 };
+	timing::graph::node node_k = g.rise_node_create(k);
+	timing::graph::node node_j = g.rise_node_create(j);
+	timing::graph::node node_i = g.fall_node_create(i);
+	timing::graph::edge edge1 = g.edge_create(node_i, node_j, timing::edge_types::TIMING_ARC, tarc);
+	timing::graph::edge edge2 = g.edge_create(node_j, node_k, timing::edge_types::NET, k);
+
+	timing::csr_graph csr(g, {node_i, node_j, node_k});
+	REQUIRE(csr.node_count() == 3);
+	REQUIRE(csr.arc_count() == 2);
+	REQUIRE(csr.node(0) == node_i);
+	REQUIRE(csr.node_index(node_k) == 2);
+	REQUIRE(csr.pin(1) == j);
+	REQUIRE(csr.node_edge(0) == timing::edges::FALL);
+	REQUIRE(csr.in_degree(0) == 0);
+	REQUIRE(csr.out_degree(0) == 1);
+	REQUIRE(csr.arc(csr.out_arcs_begin(0)) == edge1);
+	REQUIRE(csr.in_degree(2) == 1);
+	REQUIRE(csr.arc(*csr.in_arcs_begin(2)) == edge2);
+	REQUIRE(csr.source(*csr.in_arcs_begin(2)) == 1);
+	REQUIRE(csr.target(csr.out_arcs_begin(1)) == 2);
+	REQUIRE(csr.arc_type(csr.out_arcs_begin(1)) == timing::edge_types::NET);
+	REQUIRE(csr.arc_entity(csr.out_arcs_begin(0)) == tarc);
+}
+
 #include "../netlist/netlist.h"
 #include "../timing/graph_builder.h"
 
@@ -24,6 +24,12 @@ under the License.
 
 #include <boost/units/systems/si/prefixes.hpp>
 
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+
 TEST_CASE("liberty/pin capacitance", "[timing][liberty]") {
 	ophidian::standard_cell::standard_cells std_cells;
 	ophidian::timing::library_timing_arcs tarcs { &std_cells };
@@ -163,3 +169,97 @@ TEST_CASE("liberty/setup", "[timing][liberty]") {
 }
 
 
+
+namespace {
+
+// an empty file in the temporary directory, removed with the object
+struct temporary_file {
+    std::string name;
+    temporary_file() {
+        char path[] = "/tmp/ophidian_liberty_XXXXXX";
+        const int file = mkstemp(path);
+        REQUIRE( file >= 0 );
+        close(file);
+        name = path;
+    }
+    ~temporary_file() {
+        std::remove(name.c_str());
+    }
+};
+
+}
+
+TEST_CASE("liberty/cache", "[timing][liberty]") {
+    using namespace ophidian;
+    temporary_file file;
+    const std::string & cache = file.name;
+
+    standard_cell::standard_cells parsed_cells;
+    timing::library_timing_arcs parsed_tarcs { &parsed_cells };
+    timing::library parsed { &parsed_tarcs, &parsed_cells };
+    timing::liberty::read("input_files/simple_Late.lib", parsed);
+
+    // the same pin in another standard_cells
+    auto find_pin = [&parsed_cells](standard_cell::standard_cells & std_cells, entity_system::entity pin) {
+        const std::string name = parsed_cells.pin_name(pin);
+        return std_cells.pin_create(std_cells.cell_create(parsed_cells.cell_name(parsed_cells.pin_owner(pin))), name.substr(name.find(':')+1));
+    };
+
+    for(int run = 0; run < 2; ++run) // writes the cache, then loads it
+    {
+        standard_cell::standard_cells std_cells;
+        timing::library_timing_arcs tarcs { &std_cells };
+        timing::library lib { &tarcs, &std_cells };
+        timing::liberty::read("input_files/simple_Late.lib", lib, cache);
+        REQUIRE( std::ifstream(cache).good() );
+
+        const std::size_t pin_count = std_cells.pin_system().size();
+        REQUIRE( std_cells.cell_system().size() == parsed_cells.cell_system().size() );
+        REQUIRE( pin_count == parsed_cells.pin_system().size() );
+        REQUIRE( tarcs.system().size() == parsed_tarcs.system().size() );
+        for(auto pin : parsed_cells.pin_system())
+        {
+            auto cached_pin = find_pin(std_cells, pin);
+            REQUIRE( lib.pin_capacitance(cached_pin) == parsed.pin_capacitance(pin) );
+            REQUIRE( std_cells.pin_direction(cached_pin) == parsed_cells.pin_direction(pin) );
+            REQUIRE( std_cells.pin_clock_input(cached_pin) == parsed_cells.pin_clock_input(pin) );
+            REQUIRE( lib.pin_timing_arcs(cached_pin).size() == parsed.pin_timing_arcs(pin).size() );
+        }
+        for(auto arc : parsed_tarcs.system())
+        {
+            auto cached_arc = lib.timing_arc(find_pin(std_cells, parsed.timing_arc_from(arc)), find_pin(std_cells, parsed.timing_arc_to(arc)));
+            REQUIRE( lib.timing_arc_timing_sense(cached_arc) == parsed.timing_arc_timing_sense(arc) );
+            REQUIRE( lib.timing_arc_timing_type(cached_arc) == parsed.timing_arc_timing_type(arc) );
+            REQUIRE( lib.timing_arc_rise_delay(cached_arc) == parsed.timing_arc_rise_delay(arc) );
+            REQUIRE( lib.timing_arc_fall_delay(cached_arc) == parsed.timing_arc_fall_delay(arc) );
+            REQUIRE( lib.timing_arc_rise_slew(cached_arc) == parsed.timing_arc_rise_slew(arc) );
+            REQUIRE( lib.timing_arc_fall_slew(cached_arc) == parsed.timing_arc_fall_slew(arc) );
+        }
+        REQUIRE( std_cells.pin_system().size() == pin_count );
+
+        auto DFF_X80 = std_cells.cell_create("DFF_X80");
+        auto setup = lib.timing_arc(std_cells.pin_create(DFF_X80, "ck"), std_cells.pin_create(DFF_X80, "d"));
+        using namespace boost::units;
+        REQUIRE( lib.setup_rise(setup).compute(0.0*si::seconds, 0.0*si::seconds) == quantity<si::time>(1.5*si::pico*si::seconds) );
+        REQUIRE( lib.setup_fall(setup).compute(0.0*si::seconds, 0.0*si::seconds) == quantity<si::time>(2.5*si::pico*si::seconds) );
+    }
+
+    // a cache of the right size whose first cell points past the pins is parsed again
+    {
+        std::fstream file(cache, std::ios::in | std::ios::out | std::ios::binary);
+        std::uint64_t strings;
+        file.seekg(32);
+        file.read(reinterpret_cast<char*>(&strings), sizeof(strings));
+        const std::uint32_t pins_end = 0xFFFFFFFF;
+        file.seekp(88 + ((strings + 7) & ~std::uint64_t(7)) + 20);
+        file.write(reinterpret_cast<const char*>(&pins_end), sizeof(pins_end));
+        REQUIRE( file.good() );
+    }
+    standard_cell::standard_cells std_cells;
+    timing::library_timing_arcs tarcs { &std_cells };
+    timing::library lib { &tarcs, &std_cells };
+    timing::liberty::read("input_files/simple_Late.lib", lib, cache);
+    REQUIRE( std_cells.cell_system().size() == parsed_cells.cell_system().size() );
+    REQUIRE( std_cells.pin_system().size() == parsed_cells.pin_system().size() );
+    REQUIRE( tarcs.system().size() == parsed_tarcs.system().size() );
+}
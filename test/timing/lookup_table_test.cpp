@@ -84,3 +84,29 @@ TEST_CASE("lookup table/interpolation", "[timing][lut]") {
 
 }
 
+
+TEST_CASE("lookup table/batch interpolation", "[timing][lut]") {
+	ophidian::timing::lookup_table<double, double, double> table(3, 4);
+	for(std::size_t i = 0; i < table.row_count(); ++i)
+		table.row_value(i, 2.0 * i);
+	for(std::size_t j = 0; j < table.column_count(); ++j)
+		table.column_value(j, 10.0 * j * j);
+	for(std::size_t i = 0; i < table.row_count(); ++i)
+		for(std::size_t j = 0; j < table.column_count(); ++j)
+			table.at(i, j, 1.0 + i * 3.0 + j * 0.5 + i * j);
+
+	std::vector<double> rows, columns;
+	for(std::size_t k = 0; k < 150; ++k)
+	{
+		rows.push_back(-1.0 + 0.05 * k);
+		columns.push_back(-5.0 + 0.7 * k);
+	}
+	std::vector<double> results(rows.size());
+	table.compute(rows.data(), columns.data(), rows.size(), results.data());
+	for(std::size_t k = 0; k < rows.size(); ++k)
+		REQUIRE(results[k] == table.compute(rows[k], columns[k]));
+
+	REQUIRE(table.compute(2.0, 10.0) == table.at(1, 1));
+	REQUIRE(table.compute(4.0, 90.0) == table.at(2, 3));
+	REQUIRE(table.compute(3.0, 10.0) == Approx(0.5 * (table.at(1, 1) + table.at(2, 1))));
+}
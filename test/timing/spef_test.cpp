@@ -22,6 +22,7 @@ under the License.
 #include "../timing/spef.h"
 
 #include <sstream>
+#include <stdexcept>
 
 
 #include <boost/units/systems/si/prefixes.hpp>
@@ -52,3 +53,105 @@ TEST_CASE("spef read", "[spef]")
     REQUIRE( front.tree.capacitor_count() == 2 );
     REQUIRE( front.tree.lumped() == quantity<si::capacitance>(2.0*femto*farads) );
 }
+
+TEST_CASE("spef read packed", "[spef]")
+{
+    const std::string file = "*SPEF \"IEEE 1481-1998\"\n\
+*T_UNIT 1 PS\n\
+\n\
+*D_NET net_1 2.0\n\
+*CONN\n\
+*I inst_0:ZN O\n\
+*I inst_3:A2 I\n\
+*CAP\n\
+1 inst_0:ZN 0.5\n\
+2 net_1:1 0.25\n\
+3 inst_3:A2 1.25\n\
+*RES\n\
+1 inst_0:ZN net_1:1 0.002\n\
+2 net_1:1 inst_3:A2 0.001\n\
+*END\n\
+\n\
+  *D_NET net_2 1.0\n\
+  *CONN\n\
+  *P in I\n\
+  *I inst_0:A1 I\n\
+  *CAP\n\
+  1 in 1.0\n\
+  *RES\n\
+  1 in inst_0:A1 0.003\n\
+  *END\n";
+    timing::spef spef;
+    spef.read_packed(file.data(), file.size());
+
+    REQUIRE(spef.packed_trees().size() == 2);
+    const timing::packed_spef_tree & first = spef.packed_trees().front();
+    REQUIRE( first.net_name == "net_1" );
+    REQUIRE( first.source == "inst_0:ZN" );
+    REQUIRE( first.tree.node_count() == 3 );
+    REQUIRE( first.tree.tap("inst_3:A2") == 2 );
+    REQUIRE( first.tree.pred(2) == 1 );
+    REQUIRE( first.tree.resistance(2) == quantity<si::resistance>(0.001*kilo*ohms) );
+    REQUIRE( first.tree.capacitance(1) == quantity<si::capacitance>(0.25*femto*farads) );
+
+    const timing::packed_spef_tree & second = spef.packed_trees().back();
+    REQUIRE( second.net_name == "net_2" );
+    REQUIRE( second.source == "in" );
+    REQUIRE( second.tree.node_count() == 2 );
+    REQUIRE( second.tree.tap("inst_0:A1") == 1 );
+}
+
+namespace {
+
+// resistance from a node of a packed tree to its root
+quantity<si::resistance> path_resistance(const interconnection::packed_rc_tree & tree, std::size_t node) {
+    quantity<si::resistance> total;
+    for(; node != 0; node = tree.pred(node))
+        total += tree.resistance(node);
+    return total;
+}
+
+}
+
+TEST_CASE("spef read packed from file", "[spef]")
+{
+    timing::spef stream;
+    stream.read("input_files/simple.spef");
+    timing::spef packed;
+    packed.read_packed("input_files/simple.spef");
+
+    REQUIRE( stream.trees().size() == 9 );
+    REQUIRE( packed.packed_trees().size() == stream.trees().size() );
+    std::size_t taps = 0;
+    for(std::size_t i = 0; i < stream.trees().size(); ++i)
+    {
+        const timing::spef_tree & expected = stream.trees()[i];
+        const timing::packed_spef_tree & result = packed.packed_trees()[i];
+        REQUIRE( result.net_name == expected.net_name );
+        REQUIRE( result.source == expected.source );
+
+        // the nodes may be in another order, so they are compared through the taps
+        const interconnection::packed_rc_tree golden = expected.tree.pack(expected.tree.capacitor_by_name(expected.source));
+        REQUIRE( result.tree.node_count() == golden.node_count() );
+        quantity<si::capacitance> lumped;
+        for(std::size_t node = 0; node < result.tree.node_count(); ++node)
+            lumped += result.tree.capacitance(node);
+        REQUIRE( lumped.value() == Approx(expected.tree.lumped().value()) );
+        REQUIRE( result.tree.capacitance(0) == golden.capacitance(0) );
+        for(lemon::ListGraph::NodeIt cap(expected.tree.graph()); cap != lemon::INVALID; ++cap)
+        {
+            const std::string name = expected.tree.capacitor_name(cap);
+            std::size_t golden_tap;
+            try {
+                golden_tap = golden.tap(name);
+            } catch(const std::out_of_range &) {
+                continue; // not a sink
+            }
+            const std::size_t tap = result.tree.tap(name);
+            REQUIRE( result.tree.capacitance(tap) == golden.capacitance(golden_tap) );
+            REQUIRE( path_resistance(result.tree, tap).value() == Approx(path_resistance(golden, golden_tap).value()) );
+            ++taps;
+        }
+    }
+    REQUIRE( taps == 10 ); // every sink of simple.v
+}
@@ -59,3 +59,475 @@ TEST_CASE("sta/timing arcs timing", "[timing][sta]") {
 	REQUIRE(arcs.slew(arc) == quantity<si::time>(12.0 * si::seconds));
 
 }
+
+#include "../timing/generic_sta.h"
+#include "../timing/path_enumerator.h"
+#include "../timing/static_timing_analysis.h"
+#include "../timing/graph_builder.h"
+#include "../timing/liberty.h"
+#include "../parsing/verilog.h"
+#include "../netlist/verilog2netlist.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <omp.h>
+#include <unistd.h>
+
+namespace {
+
+struct simple_sta_fixture {
+    ophidian::standard_cell::standard_cells std_cells;
+    ophidian::netlist::netlist netlist{&std_cells};
+    ophidian::timing::library_timing_arcs tarcs{&std_cells};
+    ophidian::timing::library lib{&tarcs, &std_cells};
+    ophidian::timing::design_constraints dc;
+    ophidian::timing::graph graph;
+    ophidian::entity_system::vector_property< ophidian::interconnection::packed_rc_tree > rc_trees;
+
+    explicit simple_sta_fixture(const std::string & verilog_file = "input_files/simple.v") {
+        using namespace ophidian;
+        using namespace boost::units;
+        parsing::verilog v(verilog_file);
+        netlist::verilog2netlist(v, netlist);
+        dc = timing::default_design_constraints{netlist}.dc();
+        for(auto driver : dc.input_drivers)
+            std_cells.pin_direction(netlist.pin_std_cell(netlist.pin_by_name(driver.port_name)), standard_cell::pin_directions::OUTPUT);
+        std_cells.pin_direction(netlist.pin_std_cell(netlist.pin_by_name(dc.clock.port_name)), standard_cell::pin_directions::OUTPUT);
+        timing::liberty::read("input_files/simple_Late.lib", lib);
+        for(auto out_load : dc.output_loads)
+        {
+            auto PO_std_cell_pin = netlist.pin_std_cell(netlist.pin_by_name(out_load.port_name));
+            std_cells.pin_direction(PO_std_cell_pin, standard_cell::pin_directions::INPUT);
+            lib.pin_capacitance(PO_std_cell_pin, quantity<si::capacitance>(out_load.pin_load*si::femto*si::farads));
+        }
+        timing::graph_builder::build(netlist, lib, dc, graph);
+
+        // one resistor from the driver to each sink of the net
+        netlist.register_net_property(&rc_trees);
+        for(auto net : netlist.net_system())
+        {
+            interconnection::rc_tree tree;
+            entity_system::entity source;
+            for(auto pin : netlist.net_pins(net))
+                if(std_cells.pin_direction(netlist.pin_std_cell(pin)) == standard_cell::pin_directions::OUTPUT)
+                    source = pin;
+            auto root = tree.capacitor_insert(netlist.pin_name(source));
+            tree.tap_insert(root, source);
+            for(auto pin : netlist.net_pins(net))
+            {
+                if(pin == source) continue;
+                auto tap = tree.capacitor_insert(netlist.pin_name(pin));
+                tree.capacitance(tap, lib.pin_capacitance(netlist.pin_std_cell(pin)) + quantity<si::capacitance>(1.0*si::femto*si::farads));
+                tree.resistor_insert(root, tap, quantity<si::resistance>(25.0*si::ohms));
+                tree.tap_insert(tap, pin);
+            }
+            rc_trees[netlist.net_system().lookup(net)] = tree.pack(root);
+        }
+    }
+};
+
+// A design with levels of width drivers each, so that a level is split among
+// threads: an inverter fans out to width inverters, then width NAND2s read
+// pairs of them, width flip-flops sample the NANDs and width inverters drive
+// the outputs. The file is removed with the object.
+struct fanout_design {
+    std::string filename;
+
+    explicit fanout_design(std::size_t width) {
+        char path[] = "/tmp/ophidian_fanout_XXXXXX";
+        const int file = mkstemp(path);
+        REQUIRE( file >= 0 );
+        close(file);
+        filename = path;
+        std::ofstream out(filename);
+        out << "module fanout (\ninp1,\niccad_clk";
+        for(std::size_t i = 0; i < width; ++i)
+            out << ",\nout_" << i;
+        out << "\n);\n\ninput inp1;\ninput iccad_clk;\n";
+        for(std::size_t i = 0; i < width; ++i)
+            out << "output out_" << i << ";\n";
+        out << "\nwire inp1;\nwire iccad_clk;\nwire clk;\nwire root;\n";
+        for(std::size_t i = 0; i < width; ++i)
+            out << "wire m_" << i << ";\nwire p_" << i << ";\nwire q_" << i << ";\nwire out_" << i << ";\n";
+        out << "\nINV_Z80 lcb1 ( .a(iccad_clk), .o(clk) );\nINV_X1 u_root ( .a(inp1), .o(root) );\n";
+        for(std::size_t i = 0; i < width; ++i)
+        {
+            out << "INV_X1 a_" << i << " ( .a(root), .o(m_" << i << ") );\n";
+            out << "NAND2_X1 b_" << i << " ( .a(m_" << i << "), .b(m_" << (i+1)%width << "), .o(p_" << i << ") );\n";
+            out << "DFF_X80 f_" << i << " ( .d(p_" << i << "), .ck(clk), .q(q_" << i << ") );\n";
+            out << "INV_X1 c_" << i << " ( .a(q_" << i << "), .o(out_" << i << ") );\n";
+        }
+        out << "\nendmodule\n";
+    }
+
+    ~fanout_design() {
+        std::remove(filename.c_str());
+    }
+};
+
+// runs the enclosing scope with at least threads OpenMP threads, even on one core
+struct omp_threads {
+    int previous;
+    explicit omp_threads(int threads) : previous(omp_get_max_threads()) {
+        omp_set_num_threads(std::max(threads, previous));
+    }
+    ~omp_threads() {
+        omp_set_num_threads(previous);
+    }
+};
+
+}
+
+TEST_CASE("sta/parallel arrival propagation matches serial", "[timing][sta]") {
+    using namespace ophidian;
+    simple_sta_fixture fixture;
+    timing::graph_and_topology topology(fixture.graph, fixture.netlist, fixture.lib);
+
+    timing::timing_data serial_data(fixture.lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> serial(serial_data, topology, fixture.rc_trees);
+    serial.parallel(false);
+    serial.set_constraints(fixture.dc);
+    serial.update_ats();
+
+    timing::timing_data parallel_data(fixture.lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> parallel(parallel_data, topology, fixture.rc_trees);
+    REQUIRE( parallel.parallel() );
+    parallel.set_constraints(fixture.dc);
+    parallel.update_ats();
+
+    for(lemon::ListDigraph::NodeIt node(fixture.graph.G()); node != lemon::INVALID; ++node)
+    {
+        REQUIRE( parallel_data.nodes.arrival(node) == serial_data.nodes.arrival(node) );
+        REQUIRE( parallel_data.nodes.slew(node) == serial_data.nodes.slew(node) );
+        REQUIRE( parallel_data.nodes.load(node) == serial_data.nodes.load(node) );
+    }
+    REQUIRE( serial.rise_arrival(fixture.netlist.pin_by_name("out")) > boost::units::quantity<boost::units::si::time>(0.0*boost::units::si::seconds) );
+}
+
+TEST_CASE("sta/parallel arrival propagation matches serial on wide levels", "[timing][sta]") {
+    using namespace ophidian;
+    omp_threads threads(4);
+    fanout_design design(256);
+    simple_sta_fixture fixture(design.filename);
+    timing::graph_and_topology topology(fixture.graph, fixture.netlist, fixture.lib);
+    std::size_t widest = 0;
+    for(auto & level : topology.levels)
+        widest = std::max(widest, level.size());
+    REQUIRE( widest >= 2*256 ); // rise and fall drivers of a row of gates, many chunks per thread
+
+    timing::timing_data serial_data(fixture.lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> serial(serial_data, topology, fixture.rc_trees);
+    serial.parallel(false);
+    serial.set_constraints(fixture.dc);
+    serial.update_ats();
+
+    timing::timing_data parallel_data(fixture.lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> parallel(parallel_data, topology, fixture.rc_trees);
+    parallel.set_constraints(fixture.dc);
+    parallel.update_ats();
+
+    std::size_t arrivals = 0;
+    for(lemon::ListDigraph::NodeIt node(fixture.graph.G()); node != lemon::INVALID; ++node)
+    {
+        REQUIRE( parallel_data.nodes.arrival(node) == serial_data.nodes.arrival(node) );
+        REQUIRE( parallel_data.nodes.slew(node) == serial_data.nodes.slew(node) );
+        REQUIRE( parallel_data.nodes.load(node) == serial_data.nodes.load(node) );
+        arrivals += serial_data.nodes.arrival(node) > boost::units::quantity<boost::units::si::time>(0.0*boost::units::si::seconds);
+    }
+    REQUIRE( arrivals > 4*256 );
+}
+
+TEST_CASE("sta/parallel required propagation matches serial", "[timing][sta]") {
+    using namespace ophidian;
+    simple_sta_fixture fixture;
+    timing::graph_and_topology topology(fixture.graph, fixture.netlist, fixture.lib);
+
+    timing::timing_data serial_data(fixture.lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> serial(serial_data, topology, fixture.rc_trees);
+    serial.parallel(false);
+    serial.set_constraints(fixture.dc);
+    serial.update_ats();
+    serial.update_rts();
+
+    timing::timing_data parallel_data(fixture.lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> parallel(parallel_data, topology, fixture.rc_trees);
+    parallel.set_constraints(fixture.dc);
+    parallel.update_ats();
+    parallel.update_rts();
+
+    for(lemon::ListDigraph::NodeIt node(fixture.graph.G()); node != lemon::INVALID; ++node)
+        REQUIRE( parallel_data.nodes.required(node) == serial_data.nodes.required(node) );
+    REQUIRE( serial.rise_slack(fixture.netlist.pin_by_name("inp1")) == parallel.rise_slack(fixture.netlist.pin_by_name("inp1")) );
+}
+
+TEST_CASE("sta/parallel required propagation matches serial on wide levels", "[timing][sta]") {
+    using namespace ophidian;
+    omp_threads threads(4);
+    fanout_design design(256);
+    simple_sta_fixture fixture(design.filename);
+    timing::graph_and_topology topology(fixture.graph, fixture.netlist, fixture.lib);
+
+    timing::timing_data serial_data(fixture.lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> serial(serial_data, topology, fixture.rc_trees);
+    serial.parallel(false);
+    serial.set_constraints(fixture.dc);
+    serial.update_ats();
+    serial.update_rts();
+
+    timing::timing_data parallel_data(fixture.lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> parallel(parallel_data, topology, fixture.rc_trees);
+    parallel.set_constraints(fixture.dc);
+    parallel.update_ats();
+    parallel.update_rts();
+
+    for(lemon::ListDigraph::NodeIt node(fixture.graph.G()); node != lemon::INVALID; ++node)
+        REQUIRE( parallel_data.nodes.required(node) == serial_data.nodes.required(node) );
+    // the root inverter reads the requireds of all fan-out branches
+    REQUIRE( serial.rise_slack(fixture.netlist.pin_by_name("u_root:a")) == parallel.rise_slack(fixture.netlist.pin_by_name("u_root:a")) );
+    REQUIRE( serial.fall_slack(fixture.netlist.pin_by_name("u_root:a")) == parallel.fall_slack(fixture.netlist.pin_by_name("u_root:a")) );
+}
+
+TEST_CASE("sta/bulk pin timing matches the pin getters", "[timing][sta]") {
+    using namespace ophidian;
+    simple_sta_fixture fixture;
+    timing::graph_and_topology topology(fixture.graph, fixture.netlist, fixture.lib);
+    timing::timing_data data(fixture.lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> sta(data, topology, fixture.rc_trees);
+    sta.set_constraints(fixture.dc);
+    sta.update_ats();
+    sta.update_rts();
+
+    std::vector<entity_system::entity> pins(fixture.netlist.pin_system().begin(), fixture.netlist.pin_system().end());
+    std::vector<timing::pin_timing> timing;
+    sta.pins_timing(pins, timing);
+    REQUIRE( timing.size() == pins.size() );
+    for(std::size_t i = 0; i < pins.size(); ++i)
+    {
+        REQUIRE( timing[i].rise_arrival == sta.rise_arrival(pins[i]) );
+        REQUIRE( timing[i].fall_arrival == sta.fall_arrival(pins[i]) );
+        REQUIRE( timing[i].rise_slack == sta.rise_slack(pins[i]) );
+        REQUIRE( timing[i].fall_slack == sta.fall_slack(pins[i]) );
+    }
+
+    // a batch large enough to run in parallel with one unknown pin
+    std::vector<entity_system::entity> batch;
+    while(batch.size() <= 2048)
+        batch.insert(batch.end(), pins.begin(), pins.end());
+    batch.push_back(entity_system::entity{100000});
+    sta.parallel(true);
+    bool out_of_range = false;
+    try {
+        sta.pins_timing(batch, timing);
+    } catch(const std::out_of_range &) {
+        out_of_range = true;
+    }
+    REQUIRE( out_of_range );
+}
+
+TEST_CASE("sta/incremental update matches full update", "[timing][sta]") {
+    using namespace ophidian;
+    using namespace boost::units;
+    simple_sta_fixture fixture;
+    timing::graph_and_topology topology(fixture.graph, fixture.netlist, fixture.lib);
+
+    timing::timing_data incremental_data(fixture.lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> incremental(incremental_data, topology, fixture.rc_trees);
+    incremental.set_constraints(fixture.dc);
+    incremental.update_ats();
+    incremental.update_rts();
+
+    auto net = fixture.netlist.net_by_name("n1");
+    interconnection::rc_tree tree;
+    auto root = tree.capacitor_insert("u1:o");
+    tree.tap_insert(root);
+    auto tap = tree.capacitor_insert("u2:a");
+    tree.capacitance(tap, quantity<si::capacitance>(20.0*si::femto*si::farads));
+    tree.resistor_insert(root, tap, quantity<si::resistance>(500.0*si::ohms));
+    tree.tap_insert(tap);
+    fixture.rc_trees[fixture.netlist.net_system().lookup(net)] = tree.pack(root);
+
+    incremental.incremental_update_ats({net});
+    incremental.incremental_update_rts({}); // no test recomputed
+
+    timing::timing_data full_data(fixture.lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> full(full_data, topology, fixture.rc_trees);
+    full.set_constraints(fixture.dc);
+    full.update_ats();
+    full.update_rts();
+
+    for(lemon::ListDigraph::NodeIt node(fixture.graph.G()); node != lemon::INVALID; ++node)
+    {
+        REQUIRE( incremental_data.nodes.arrival(node) == full_data.nodes.arrival(node) );
+        REQUIRE( incremental_data.nodes.slew(node) == full_data.nodes.slew(node) );
+        REQUIRE( incremental_data.nodes.required(node) == full_data.nodes.required(node) );
+    }
+}
+
+TEST_CASE("sta/incremental update_timing matches a full update", "[timing][sta]") {
+    using namespace ophidian;
+    using namespace boost::units;
+    simple_sta_fixture fixture;
+    auto analysis = [&fixture](timing::static_timing_analysis & sta) {
+        sta.graph(fixture.graph);
+        sta.rc_trees(fixture.rc_trees);
+        sta.late_lib(fixture.lib);
+        sta.early_lib(fixture.lib);
+        sta.netlist(fixture.netlist);
+        sta.set_constraints(fixture.dc);
+    };
+    timing::static_timing_analysis incremental;
+    analysis(incremental);
+    incremental.update_timing();
+
+    auto reroute = [&fixture](const std::string & net_name, const std::string & source, const std::string & sink, double resistance) {
+        interconnection::rc_tree tree;
+        auto root = tree.capacitor_insert(source);
+        tree.tap_insert(root);
+        auto tap = tree.capacitor_insert(sink);
+        tree.capacitance(tap, quantity<si::capacitance>(20.0*si::femto*si::farads));
+        tree.resistor_insert(root, tap, quantity<si::resistance>(resistance*si::ohms));
+        tree.tap_insert(tap);
+        auto net = fixture.netlist.net_by_name(net_name);
+        fixture.rc_trees[fixture.netlist.net_system().lookup(net)] = tree.pack(root);
+        return net;
+    };
+    // the data and the clock pins of the flip-flop, so the test is recomputed
+    incremental.update_timing({reroute("n2", "u2:o", "f1:d", 800.0)});
+    incremental.update_timing({reroute("lcb1_fo", "lcb1:o", "f1:ck", 400.0)});
+
+    timing::static_timing_analysis full;
+    analysis(full);
+    full.update_timing();
+
+    for(auto pin : fixture.netlist.pin_system())
+    {
+        REQUIRE( incremental.late_rise_slack(pin) == full.late_rise_slack(pin) );
+        REQUIRE( incremental.late_fall_slack(pin) == full.late_fall_slack(pin) );
+        REQUIRE( incremental.early_rise_slack(pin) == full.early_rise_slack(pin) );
+        REQUIRE( incremental.early_fall_slack(pin) == full.early_fall_slack(pin) );
+    }
+    REQUIRE( incremental.late_wns() == full.late_wns() );
+    REQUIRE( incremental.late_tns() == full.late_tns() );
+    REQUIRE( incremental.early_wns() == full.early_wns() );
+    REQUIRE( incremental.early_tns() == full.early_tns() );
+}
+
+TEST_CASE("sta/corners propagated together match separate runs", "[timing][sta]") {
+    using namespace ophidian;
+    using namespace boost::units;
+    simple_sta_fixture fixture;
+    timing::library fast_lib{&fixture.tarcs, &fixture.std_cells};
+    timing::liberty::read("input_files/simple_Early.lib", fast_lib);
+    for(auto out_load : fixture.dc.output_loads)
+        fast_lib.pin_capacitance(fixture.netlist.pin_std_cell(fixture.netlist.pin_by_name(out_load.port_name)), quantity<si::capacitance>(out_load.pin_load*si::femto*si::farads));
+    timing::graph_and_topology topology(fixture.graph, fixture.netlist, fixture.lib);
+
+    timing::timing_data slow_corner(fixture.lib, fixture.graph);
+    timing::timing_data fast_corner(fast_lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> corners({&slow_corner, &fast_corner}, topology, fixture.rc_trees);
+    REQUIRE( corners.corner_count() == 2 );
+    corners.set_constraints(fixture.dc, 0);
+    corners.set_constraints(fixture.dc, 1);
+    corners.update_ats();
+    corners.update_rts();
+
+    timing::timing_data slow_data(fixture.lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> slow(slow_data, topology, fixture.rc_trees);
+    slow.set_constraints(fixture.dc);
+    slow.update_ats();
+    slow.update_rts();
+
+    timing::timing_data fast_data(fast_lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> fast(fast_data, topology, fixture.rc_trees);
+    fast.set_constraints(fixture.dc);
+    fast.update_ats();
+    fast.update_rts();
+
+    for(lemon::ListDigraph::NodeIt node(fixture.graph.G()); node != lemon::INVALID; ++node)
+    {
+        REQUIRE( slow_corner.nodes.arrival(node) == slow_data.nodes.arrival(node) );
+        REQUIRE( slow_corner.nodes.slew(node) == slow_data.nodes.slew(node) );
+        REQUIRE( slow_corner.nodes.required(node) == slow_data.nodes.required(node) );
+        REQUIRE( fast_corner.nodes.arrival(node) == fast_data.nodes.arrival(node) );
+        REQUIRE( fast_corner.nodes.slew(node) == fast_data.nodes.slew(node) );
+        REQUIRE( fast_corner.nodes.required(node) == fast_data.nodes.required(node) );
+    }
+    auto out = fixture.netlist.pin_by_name("out");
+    REQUIRE( corners.rise_arrival(out, 1) < corners.rise_arrival(out, 0) );
+}
+
+namespace {
+
+// slacks of every path ending at the node, by depth first search
+void all_path_slacks(const ophidian::timing::graph & g, const ophidian::timing::timing_data & timing, lemon::ListDigraph::Node node, boost::units::quantity<boost::units::si::time> delay, boost::units::quantity<boost::units::si::time> required, std::vector<double> & slacks) {
+    if(lemon::countInArcs(g.G(), node) == 0)
+    {
+        slacks.push_back((required - timing.nodes.arrival(node) - delay).value());
+        return;
+    }
+    for(lemon::ListDigraph::InArcIt arc(g.G(), node); arc != lemon::INVALID; ++arc)
+        all_path_slacks(g, timing, g.edge_source(arc), delay + timing.arcs.delay(arc), required, slacks);
+}
+
+}
+
+TEST_CASE("sta/worst paths enumeration", "[timing][sta]") {
+    using namespace ophidian;
+    simple_sta_fixture fixture;
+    timing::graph_and_topology topology(fixture.graph, fixture.netlist, fixture.lib);
+    timing::timing_data data(fixture.lib, fixture.graph);
+    timing::generic_sta<timing::effective_capacitance_wire_model, timing::pessimistic> sta(data, topology, fixture.rc_trees);
+    sta.set_constraints(fixture.dc);
+    sta.update_ats();
+    sta.update_rts();
+
+    timing::path_enumerator<timing::pessimistic> enumerator(topology, data);
+
+    auto d = fixture.graph.rise_node(fixture.netlist.pin_by_name("f1:d"));
+    std::vector<double> expected;
+    all_path_slacks(fixture.graph, data, d, boost::units::quantity<boost::units::si::time>(), data.nodes.required(d), expected);
+    std::sort(expected.begin(), expected.end());
+    REQUIRE( expected.size() > 1 );
+
+    auto paths = enumerator.endpoint_paths(d, expected.size() + 1);
+    REQUIRE( paths.size() == expected.size() );
+    for(std::size_t i = 0; i < paths.size(); ++i)
+    {
+        REQUIRE( paths[i].slack.value() == Approx(expected[i]) );
+        REQUIRE( paths[i].nodes.size() == paths[i].arcs.size() + 1 );
+        REQUIRE( paths[i].nodes.back() == d );
+        for(std::size_t a = 0; a < paths[i].arcs.size(); ++a)
+        {
+            REQUIRE( fixture.graph.edge_source(paths[i].arcs[a]) == paths[i].nodes[a] );
+            REQUIRE( fixture.graph.edge_target(paths[i].arcs[a]) == paths[i].nodes[a+1] );
+        }
+    }
+    REQUIRE( enumerator.endpoint_paths(d, 1).front().slack == paths.front().slack );
+    REQUIRE( enumerator.endpoint_paths(d, 1).front().nodes == paths.front().nodes );
+
+    auto worst = enumerator.worst_paths(4);
+    REQUIRE( worst.size() == 4 );
+    for(std::size_t i = 1; i < worst.size(); ++i)
+        REQUIRE( worst[i-1].slack <= worst[i].slack );
+    REQUIRE( worst.front().slack <= paths.front().slack );
+    auto per_endpoint = enumerator.endpoint_paths(std::vector<lemon::ListDigraph::Node>{d, d}, 2);
+    REQUIRE( per_endpoint.size() == 2 );
+    REQUIRE( per_endpoint[1].size() == 2 );
+    REQUIRE( per_endpoint[1][1].slack == paths[1].slack );
+}
+
+TEST_CASE("sta/worst and total negative slacks before the first update", "[timing][sta]") {
+    using namespace ophidian;
+    simple_sta_fixture fixture;
+    timing::static_timing_analysis sta;
+    REQUIRE( sta.late_tns() == timing::TimeType() );
+    REQUIRE( sta.early_tns() == timing::TimeType() );
+    REQUIRE( sta.late_wns() == std::numeric_limits<timing::TimeType>::max() );
+    REQUIRE( sta.early_endpoint_slacks().size() == 0 );
+    const std::size_t corner = sta.add_corner(fixture.lib, fixture.lib, fixture.dc);
+    REQUIRE( sta.late_tns(corner) == timing::TimeType() );
+    REQUIRE( sta.early_wns(corner) == std::numeric_limits<timing::TimeType>::max() );
+    REQUIRE( sta.late_endpoint_slacks(corner).size() == 0 );
+}